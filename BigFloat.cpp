@@ -0,0 +1,494 @@
+#include "BigFloat.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <deque>
+#include <stdexcept>
+
+const uint64_t BigFloat::DEFAULT_PRECISION = 128;
+
+// Whether any of the bits below the given one are set in |n|.
+bool has_bits_below(const Bignum& n, const uint64_t bit) {
+    const std::deque<uint32_t>& digits = n.digits();
+    const uint64_t index = bit / Bignum::BITS_IN_DIGIT;
+
+    for (uint64_t i = 0; i < index && i < digits.size(); ++i) {
+        if (digits[i] != 0U)
+            return true;
+    }
+
+    return index < digits.size() && (digits[index] & ((1U << (bit % Bignum::BITS_IN_DIGIT)) - 1)) != 0U;
+}
+
+// The position just above the leading bit: |x| < 2^top(x) <= 2|x|.
+int64_t top(const BigFloat& x) {
+    return x.exponent() + (int64_t) x.mantissa().bit_length();
+}
+
+Bignum shifted(const Bignum& n, const int64_t shift) {
+    if (shift >= 0)
+        return n << (unsigned int) shift;
+    if ((uint64_t) -shift >= n.bit_length())
+        return Bignum(0);
+
+    return n >> (unsigned int) -shift;
+}
+
+int64_t to_int64(const Bignum& n) {
+    const std::deque<uint32_t>& digits = n.digits();
+    uint64_t magnitude = digits[0];
+    if (digits.size() > 1)
+        magnitude |= (uint64_t) digits[1] << Bignum::BITS_IN_DIGIT;
+
+    return n.signum() < 0 ? -(int64_t) magnitude : (int64_t) magnitude;
+}
+
+// The part of the product of two magnitudes made of the digit products
+// at positions skip and above.  What is left out is less than
+// 2 skip BASE^(skip + 1).
+Bignum high_product(const std::deque<uint32_t>& first, const std::deque<uint32_t>& second,
+    const std::deque<uint32_t>::size_type skip) {
+    std::deque<uint32_t> product(first.size() + second.size(), 0U);
+
+    for (std::deque<uint32_t>::size_type i = 0; i < first.size(); ++i) {
+        std::deque<uint32_t>::size_type j = skip > i ? skip - i : 0;
+        if (j >= second.size())
+            continue;
+
+        uint64_t carry(0);
+        for (; j < second.size(); ++j) {
+            uint64_t sum = (uint64_t) first[i] * second[j] + product[i + j] + carry;
+            product[i + j] = (uint32_t) sum;
+            carry = sum >> Bignum::BITS_IN_DIGIT;
+        }
+        for (std::deque<uint32_t>::size_type k = i + second.size(); carry != 0; ++k) {
+            uint64_t sum = product[k] + carry;
+            product[k] = (uint32_t) sum;
+            carry = sum >> Bignum::BITS_IN_DIGIT;
+        }
+    }
+
+    while (product.size() > 1 && product.back() == 0U)
+        product.pop_back();
+    if (product.back() == 0U)
+        return Bignum(0);
+
+    return Bignum(product, 1);
+}
+
+// ln 2 = 2 atanh(1/3), times 2^w, within two units.
+Bignum ln2_fixed(const uint64_t w) {
+    const unsigned int guard = 64;
+
+    Bignum sum(0);
+    Bignum power = (Bignum(1) << (unsigned int) (w + guard)) / 3;
+    for (int64_t k = 0; power.signum() != 0; ++k) {
+        sum += power / (2 * k + 1);
+        power /= 9;
+    }
+
+    return (sum << 1) >> guard;
+}
+
+// exp(x) ~ mantissa * 2^exponent, within error units of the mantissa,
+// working with about w bits: x = k ln 2 + r, and exp(r) is the Taylor
+// series at r / 2^h squared h times.
+void exp_approximation(const BigFloat& x, const uint64_t w, Bignum& mantissa, int64_t& exponent, Bignum& error) {
+    const int64_t magnitude_bits = std::max(top(x), (int64_t) 0);
+    if (magnitude_bits > 62)
+        throw std::overflow_error("exponential out of range");
+
+    const unsigned int halvings = (unsigned int) std::sqrt((double) w) / 2 + 4;
+    const uint64_t working = w + magnitude_bits + halvings + 32;
+    const Bignum one = Bignum(1) << (unsigned int) working;
+
+    const Bignum fixed = shifted(x.mantissa(), x.exponent() + (int64_t) working);
+    const Bignum ln2 = ln2_fixed(working);
+    const Bignum k = fixed / ln2;
+    const Bignum reduced = (fixed - k * ln2) >> halvings;
+
+    Bignum sum = one;
+    Bignum term = one;
+    int64_t n = 1;
+    for (; term.signum() != 0; ++n) {
+        term = (term * reduced >> (unsigned int) working) / n;
+        sum += term;
+    }
+    for (unsigned int i = 0; i < halvings; ++i)
+        sum = sum * sum >> (unsigned int) working;
+
+    mantissa = sum;
+    exponent = to_int64(k) - (int64_t) working;
+    error = (k.abs() * 4 + (Bignum(n + 8) << halvings)) * 4;
+}
+
+// log(x) ~ mantissa * 2^exponent, within error units of the mantissa:
+// x = y 2^n with 3/4 <= y < 3/2, and log y = 2 atanh((y - 1) / (y + 1)).
+void log_approximation(const BigFloat& x, const uint64_t w, Bignum& mantissa, int64_t& exponent, Bignum& error) {
+    const uint64_t length = x.mantissa().bit_length();
+    int64_t n = x.exponent() + (int64_t) length;
+    const bool doubled = length < 2 || !x.mantissa().test_bit(length - 2);
+    if (doubled)
+        --n;
+
+    const uint64_t n_bits = Bignum(n).bit_length();
+    const uint64_t working = w + n_bits + 32;
+    const Bignum one = Bignum(1) << (unsigned int) working;
+
+    Bignum y = shifted(x.mantissa(), (int64_t) working - (int64_t) length);
+    if (doubled)
+        y <<= 1;
+
+    const Bignum z = ((y - one) << (unsigned int) working) / (y + one);
+    const Bignum z_squared = z * z >> (unsigned int) working;
+
+    Bignum sum(0);
+    Bignum term = z;
+    int64_t terms = 0;
+    for (; term.signum() != 0; ++terms) {
+        sum += term / (2 * terms + 1);
+        term = term * z_squared >> (unsigned int) working;
+    }
+
+    mantissa = (sum << 1) + ln2_fixed(working) * n;
+    exponent = -(int64_t) working;
+    error = (Bignum(n).abs() + terms + 8) * 8;
+}
+
+void check_precision(const uint64_t precision) {
+    if (precision == 0)
+        throw std::invalid_argument("precision must be at least one bit");
+}
+
+BigFloat::BigFloat(const Bignum& n) : significand(0), scale(0), bits(DEFAULT_PRECISION) {
+    assign(n, 0);
+}
+
+BigFloat::BigFloat(const Bignum& n, const uint64_t precision) : significand(0), scale(0), bits(precision) {
+    check_precision(precision);
+    assign(n, 0);
+}
+
+BigFloat::BigFloat(const Bignum& mantissa, const int64_t exponent, const uint64_t precision)
+    : significand(0), scale(0), bits(precision) {
+    check_precision(precision);
+    assign(mantissa, exponent);
+}
+
+// Only the digits holding the leading precision + 2 bits are copied.  The
+// digits below them can only change the rounding when the kept ones end
+// exactly halfway between two representable values with an even one
+// below, so only then are they scanned for a sticky bit; otherwise this
+// costs O(precision) however long n is.
+void BigFloat::assign(const Bignum& n, const int64_t exponent) {
+    const std::deque<uint32_t>& digits = n.digits();
+    const std::deque<uint32_t>::size_type keep = (bits + 2) / Bignum::BITS_IN_DIGIT + 2;
+
+    if (digits.size() <= keep) {
+        significand = n;
+        scale = exponent;
+        round(false);
+        return;
+    }
+
+    const std::deque<uint32_t>::size_type dropped = digits.size() - keep;
+    significand = Bignum(std::deque<uint32_t>(digits.begin() + dropped, digits.end()), n.signum());
+    scale = exponent + (int64_t) (dropped * Bignum::BITS_IN_DIGIT);
+
+    const Bignum magnitude = significand.abs();
+    const uint64_t guard = magnitude.bit_length() - bits - 1;
+    bool sticky = false;
+    if (magnitude.test_bit(guard) && !magnitude.test_bit(guard + 1) && !has_bits_below(magnitude, guard)) {
+        for (std::deque<uint32_t>::size_type i = dropped; i-- > 0 && !sticky;)
+            sticky = digits[i] != 0U;
+    }
+
+    round(sticky);
+}
+
+// Rounds the significand to nearest, ties to even, at the precision.  A
+// sticky significand has been truncated from something slightly larger
+// in magnitude, and must then have more bits than the precision.
+void BigFloat::round(const bool sticky) {
+    const int sign = significand.signum();
+    if (sign == 0) {
+        scale = 0;
+        return;
+    }
+
+    Bignum magnitude = significand.abs();
+    const uint64_t length = magnitude.bit_length();
+    if (length > bits) {
+        const uint64_t shift = length - bits;
+        const bool half = magnitude.test_bit(shift - 1);
+        const bool rest = sticky || has_bits_below(magnitude, shift - 1);
+
+        magnitude >>= (unsigned int) shift;
+        scale += (int64_t) shift;
+        if (half && (rest || magnitude.test_bit(0))) {
+            magnitude += 1;
+            if (magnitude.bit_length() > bits) {
+                magnitude >>= 1;
+                ++scale;
+            }
+        }
+    } else if (length < bits) {
+        magnitude <<= (unsigned int) (bits - length);
+        scale -= (int64_t) (bits - length);
+    }
+
+    significand = sign < 0 ? -magnitude : magnitude;
+}
+
+const BigFloat& BigFloat::operator+=(const BigFloat& other) {
+    const uint64_t precision = std::max(bits, other.bits);
+    if (other.signum() == 0)
+        return *this = with_precision(precision);
+    if (signum() == 0)
+        return *this = other.with_precision(precision);
+
+    const bool this_larger = top(*this) >= top(other);
+    const BigFloat larger = this_larger ? *this : other;
+    const BigFloat smaller = this_larger ? other : *this;
+    const uint64_t width = std::max(larger.significand.bit_length(), precision) + 3;
+
+    if (top(larger) - top(smaller) > (int64_t) width) {
+        // The smaller operand lies below every rounding boundary near the
+        // larger one, so only its sign can matter.
+        const unsigned int shift = (unsigned int) (width - larger.significand.bit_length());
+        significand = (larger.significand << shift) + smaller.signum();
+        scale = larger.scale - shift;
+    } else {
+        const int64_t exponent = std::min(larger.scale, smaller.scale);
+        significand = shifted(larger.significand, larger.scale - exponent)
+            + shifted(smaller.significand, smaller.scale - exponent);
+        scale = exponent;
+    }
+
+    bits = precision;
+    round(false);
+
+    return *this;
+}
+
+const BigFloat& BigFloat::operator-=(const BigFloat& other) {
+    return *this += -other;
+}
+
+// Only the leading digit products are formed, with a few guard digits.
+// The low products left out add less than a known bound, and if the
+// rounding comes out the same at both ends of that range it is final;
+// otherwise the full product decides.
+const BigFloat& BigFloat::operator*=(const BigFloat& other) {
+    const uint64_t precision = std::max(bits, other.bits);
+    const int sign = signum() * other.signum();
+    const int64_t exponent = scale + other.scale;
+
+    if (sign == 0) {
+        significand = 0;
+        scale = 0;
+        bits = precision;
+        return *this;
+    }
+
+    const std::deque<uint32_t>& first = significand.digits();
+    const std::deque<uint32_t>& second = other.significand.digits();
+    const std::deque<uint32_t>::size_type keep = precision / Bignum::BITS_IN_DIGIT + 3;
+
+    if (first.size() + second.size() > keep + 1) {
+        const std::deque<uint32_t>::size_type skip = first.size() + second.size() - keep;
+        const Bignum low = high_product(first, second, skip);
+        const Bignum high = low + (Bignum((int64_t) (2 * skip)) << (unsigned int) (Bignum::BITS_IN_DIGIT * (skip + 1))) - 1;
+
+        const BigFloat below(sign < 0 ? -low : low, exponent, precision);
+        const BigFloat above(sign < 0 ? -high : high, exponent, precision);
+        if (below.significand == above.significand && below.scale == above.scale)
+            return *this = below;
+    }
+
+    return *this = BigFloat(significand * other.significand, exponent, precision);
+}
+
+const BigFloat& BigFloat::operator/=(const BigFloat& other) {
+    if (other.signum() == 0)
+        throw std::domain_error("division by zero");
+
+    const uint64_t precision = std::max(bits, other.bits);
+    const int sign = signum() * other.signum();
+    if (sign == 0) {
+        bits = precision;
+        return *this;
+    }
+
+    // At least precision + 1 quotient bits, the rest folded into sticky.
+    const int64_t shift = std::max((int64_t) (precision + 2 + other.significand.bit_length())
+        - (int64_t) significand.bit_length(), (int64_t) 0);
+    const Bignum numerator = significand.abs() << (unsigned int) shift;
+    const Bignum divisor = other.significand.abs();
+    const Bignum quotient = numerator / divisor;
+    const bool sticky = quotient * divisor != numerator;
+
+    significand = sign < 0 ? -quotient : quotient;
+    scale = scale - other.scale - shift;
+    bits = precision;
+    round(sticky);
+
+    return *this;
+}
+
+BigFloat BigFloat::operator-() const {
+    BigFloat negated(*this);
+    negated.significand = -significand;
+    return negated;
+}
+
+BigFloat BigFloat::sqrt() const {
+    if (signum() < 0)
+        throw std::domain_error("square root of a negative number");
+    if (signum() == 0)
+        return *this;
+
+    // At least 2 (precision + 2) bits under the root, and an even exponent.
+    int64_t shift = std::max((int64_t) (2 * (bits + 2)) - (int64_t) significand.bit_length(), (int64_t) 0);
+    if ((scale - shift) % 2 != 0)
+        ++shift;
+
+    const Bignum radicand = significand << (unsigned int) shift;
+    BigFloat root(*this);
+    root.significand = integer_square_root(radicand);
+    root.scale = (scale - shift) / 2;
+    root.round(root.significand * root.significand != radicand);
+
+    return root;
+}
+
+// Ziv's strategy: evaluate with an error bound at growing working
+// precision until both ends of the error interval round alike.  log 1
+// and exp 0 are the only exact results, and are answered up front.
+BigFloat BigFloat::log() const {
+    if (signum() <= 0)
+        throw std::domain_error("logarithm of a non-positive number");
+    if (compare(BigFloat(Bignum(1), bits)) == 0)
+        return BigFloat(Bignum(0), bits);
+
+    for (uint64_t w = bits + 32;; w += w / 2) {
+        Bignum mantissa(0);
+        Bignum error(0);
+        int64_t exponent;
+        log_approximation(*this, w, mantissa, exponent, error);
+
+        const BigFloat low(mantissa - error, exponent, bits);
+        if (low == BigFloat(mantissa + error, exponent, bits))
+            return low;
+    }
+}
+
+BigFloat BigFloat::exp() const {
+    if (signum() == 0)
+        return BigFloat(Bignum(1), bits);
+
+    for (uint64_t w = bits + 32;; w += w / 2) {
+        Bignum mantissa(0);
+        Bignum error(0);
+        int64_t exponent;
+        exp_approximation(*this, w, mantissa, exponent, error);
+
+        const BigFloat low(mantissa - error, exponent, bits);
+        if (low == BigFloat(mantissa + error, exponent, bits))
+            return low;
+    }
+}
+
+BigFloat BigFloat::with_precision(const uint64_t precision) const {
+    return BigFloat(significand, scale, precision);
+}
+
+int BigFloat::compare(const BigFloat& other) const {
+    if (signum() != other.signum())
+        return signum() < other.signum() ? -1 : 1;
+    if (signum() == 0)
+        return 0;
+
+    if (top(*this) != top(other))
+        return top(*this) < top(other) ? -signum() : signum();
+
+    const int64_t exponent = std::min(scale, other.scale);
+    return shifted(significand, scale - exponent).compare(shifted(other.significand, other.scale - exponent));
+}
+
+int BigFloat::signum() const {
+    return significand.signum();
+}
+
+const Bignum& BigFloat::mantissa() const {
+    return significand;
+}
+
+int64_t BigFloat::exponent() const {
+    return scale;
+}
+
+uint64_t BigFloat::precision() const {
+    return bits;
+}
+
+// Truncates toward zero.
+Bignum BigFloat::to_bignum() const {
+    if (scale > (int64_t) UINT_MAX)
+        throw std::length_error("value too large to materialize");
+
+    return shifted(significand, scale);
+}
+
+double BigFloat::to_double() const {
+    const BigFloat rounded = with_precision(53);
+    if (rounded.signum() == 0)
+        return 0.0;
+
+    const int64_t exponent = std::max(std::min(rounded.scale, (int64_t) INT_MAX), (int64_t) INT_MIN);
+    return std::ldexp((double) to_int64(rounded.significand), (int) exponent);
+}
+
+bool operator==(const BigFloat& left, const BigFloat& right) {
+    return left.compare(right) == 0;
+}
+
+bool operator!=(const BigFloat& left, const BigFloat& right) {
+    return left.compare(right) != 0;
+}
+
+bool operator<(const BigFloat& left, const BigFloat& right) {
+    return left.compare(right) < 0;
+}
+
+bool operator<=(const BigFloat& left, const BigFloat& right) {
+    return left.compare(right) <= 0;
+}
+
+bool operator>(const BigFloat& left, const BigFloat& right) {
+    return left.compare(right) > 0;
+}
+
+bool operator>=(const BigFloat& left, const BigFloat& right) {
+    return left.compare(right) >= 0;
+}
+
+BigFloat operator+(const BigFloat& left, const BigFloat& right) {
+    return BigFloat(left) += right;
+}
+
+BigFloat operator-(const BigFloat& left, const BigFloat& right) {
+    return BigFloat(left) -= right;
+}
+
+BigFloat operator*(const BigFloat& left, const BigFloat& right) {
+    return BigFloat(left) *= right;
+}
+
+BigFloat operator/(const BigFloat& left, const BigFloat& right) {
+    return BigFloat(left) /= right;
+}
+
+std::ostream& operator<<(std::ostream& out, const BigFloat& x) {
+    return out << x.mantissa() << " * 2^" << x.exponent();
+}
@@ -0,0 +1,61 @@
+#ifndef PHOLSER_BIG_FLOAT_H
+#define PHOLSER_BIG_FLOAT_H
+
+#include "Bignum.h"
+#include <tr1/cstdint>
+
+// A binary floating-point value  mantissa * 2^exponent  whose mantissa is
+// a Bignum of exactly precision() bits (or zero).  Every operation rounds
+// its exact result to nearest, ties to even, at the larger precision of
+// its operands; log() and exp() evaluate at growing working precision
+// until the rounding is certain.
+class BigFloat {
+    public:
+        static const uint64_t DEFAULT_PRECISION;
+
+        BigFloat(const Bignum&);
+        BigFloat(const Bignum&, uint64_t);
+        BigFloat(const Bignum&, int64_t, uint64_t);
+
+        const BigFloat& operator+=(const BigFloat&);
+        const BigFloat& operator-=(const BigFloat&);
+        const BigFloat& operator*=(const BigFloat&);
+        const BigFloat& operator/=(const BigFloat&);
+        BigFloat operator-() const;
+
+        BigFloat sqrt() const;
+        BigFloat log() const;
+        BigFloat exp() const;
+        BigFloat with_precision(uint64_t) const;
+
+        int compare(const BigFloat&) const;
+        int signum() const;
+        const Bignum& mantissa() const;
+        int64_t exponent() const;
+        uint64_t precision() const;
+
+        Bignum to_bignum() const;
+        double to_double() const;
+
+    private:
+        Bignum significand;
+        int64_t scale;
+        uint64_t bits;
+
+        void assign(const Bignum&, int64_t);
+        void round(bool);
+};
+
+bool operator==(const BigFloat&, const BigFloat&);
+bool operator!=(const BigFloat&, const BigFloat&);
+bool operator<(const BigFloat&, const BigFloat&);
+bool operator<=(const BigFloat&, const BigFloat&);
+bool operator>(const BigFloat&, const BigFloat&);
+bool operator>=(const BigFloat&, const BigFloat&);
+BigFloat operator+(const BigFloat&, const BigFloat&);
+BigFloat operator-(const BigFloat&, const BigFloat&);
+BigFloat operator*(const BigFloat&, const BigFloat&);
+BigFloat operator/(const BigFloat&, const BigFloat&);
+std::ostream& operator<<(std::ostream&, const BigFloat&);
+
+#endif  // PHOLSER_BIG_FLOAT_H
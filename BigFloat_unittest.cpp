@@ -0,0 +1,181 @@
+#include "BigFloat.h"
+#include "RandomBignum.h"
+#include "gtest/gtest.h"
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+BigFloat from_double(double x) {
+    int exponent;
+    double fraction = std::frexp(x, &exponent);
+
+    return BigFloat(Bignum((int64_t) std::ldexp(fraction, 53)), exponent - 53, 53);
+}
+
+Bignum power_of_two(unsigned int exponent) {
+    return Bignum(1) << exponent;
+}
+
+TEST(BigFloatTest, MantissasAreNormalizedToThePrecision) {
+    BigFloat x(Bignum(3), 10);
+
+    ASSERT_EQ(Bignum(3 << 8), x.mantissa());
+    ASSERT_EQ(-8, x.exponent());
+    ASSERT_EQ(10U, x.precision());
+    ASSERT_EQ(Bignum(3), x.to_bignum());
+}
+
+TEST(BigFloatTest, ConvertingFromBignumRoundsToNearestEven) {
+    ASSERT_EQ(power_of_two(100), BigFloat(power_of_two(100) + 1, 53).to_bignum());
+    ASSERT_EQ(power_of_two(100), BigFloat(power_of_two(100) + power_of_two(47), 53).to_bignum());
+    ASSERT_EQ(power_of_two(100) + power_of_two(48),
+        BigFloat(power_of_two(100) + power_of_two(47) + 1, 53).to_bignum());
+    ASSERT_EQ(power_of_two(100) + power_of_two(49),
+        BigFloat(power_of_two(100) + power_of_two(47) * 3, 53).to_bignum());
+    ASSERT_EQ(power_of_two(101), BigFloat(power_of_two(101) - 1, 53).to_bignum());
+    ASSERT_EQ(-power_of_two(101), BigFloat(-power_of_two(101) + 1, 53).to_bignum());
+}
+
+TEST(BigFloatTest, ConvertingFromHugeBignumsOnlyNeedsTheLeadingDigits) {
+    Bignum huge = power_of_two(1 << 24) + power_of_two(1000);
+    BigFloat x(huge, 64);
+
+    // Away from a halfway case the half-million dropped digits cannot move
+    // the rounding, so changing them leaves the result alone.
+    ASSERT_EQ(power_of_two(63), x.mantissa());
+    ASSERT_EQ(2U, x.mantissa().digits().size());
+    ASSERT_EQ((1 << 24) - 63, x.exponent());
+    ASSERT_EQ(x, BigFloat(huge + 1, 64));
+    ASSERT_EQ(x, BigFloat(huge - power_of_two(1001), 64));
+    ASSERT_EQ(-x, BigFloat(-huge - 1, 64));
+    ASSERT_EQ(power_of_two(1 << 24), x.to_bignum());
+}
+
+TEST(BigFloatTest, HugeHalfwayCasesStillSeeTheDroppedDigits) {
+    Bignum halfway = power_of_two(1 << 20) + power_of_two((1 << 20) - 64);
+
+    ASSERT_EQ(power_of_two(1 << 20), BigFloat(halfway, 64).to_bignum());
+    ASSERT_EQ(power_of_two(1 << 20) + power_of_two((1 << 20) - 63), BigFloat(halfway + 1, 64).to_bignum());
+    ASSERT_EQ(-power_of_two(1 << 20) - power_of_two((1 << 20) - 63), BigFloat(-halfway - 1, 64).to_bignum());
+}
+
+TEST(BigFloatTest, ConvertingToBignumTruncatesTowardZero) {
+    ASSERT_EQ(Bignum(3), BigFloat(Bignum(7), -1, 10).to_bignum());
+    ASSERT_EQ(Bignum(-3), BigFloat(Bignum(-7), -1, 10).to_bignum());
+    ASSERT_EQ(Bignum(0), BigFloat(Bignum(1), -1000, 10).to_bignum());
+}
+
+TEST(BigFloatTest, AdditionRoundsCorrectly) {
+    BigFloat one(Bignum(1), 64);
+    BigFloat tiny(Bignum(1), -200, 64);
+
+    ASSERT_EQ(one, one + tiny);
+    ASSERT_EQ(one, one - tiny);
+    ASSERT_EQ(BigFloat(power_of_two(200) - 1, -200, 300), BigFloat(Bignum(1), 300) - tiny);
+    ASSERT_EQ(BigFloat(Bignum(1), 65),
+        BigFloat(power_of_two(64) + 1, 65) - BigFloat(power_of_two(64), 65));
+    ASSERT_EQ(0, (one - one).signum());
+}
+
+TEST(BigFloatTest, ArithmeticMatchesDoubles) {
+    const double values[] = { 1.0, 3.0, 0.1, -2.5, 1e300, 7.25e-300, 123456.789, -0.333, 6.02214076e23 };
+    const int count = sizeof(values) / sizeof(values[0]);
+
+    for (int i = 0; i < count; ++i) {
+        for (int j = 0; j < count; ++j) {
+            BigFloat x = from_double(values[i]);
+            BigFloat y = from_double(values[j]);
+            ASSERT_EQ(values[i] + values[j], (x + y).to_double()) << i << " " << j;
+            ASSERT_EQ(values[i] - values[j], (x - y).to_double()) << i << " " << j;
+            ASSERT_EQ(values[i] * values[j], (x * y).to_double()) << i << " " << j;
+            ASSERT_EQ(values[i] / values[j], (x / y).to_double()) << i << " " << j;
+        }
+        if (values[i] > 0) {
+            ASSERT_EQ(std::sqrt(values[i]), from_double(values[i]).sqrt().to_double()) << i;
+        }
+    }
+}
+
+TEST(BigFloatTest, ShortProductsAgreeWithFullProducts) {
+    RandomBignum random(12345);
+    for (int i = 0; i < 200; ++i) {
+        Bignum a = random.with_bit_length(257);
+        Bignum b = random.with_bit_length(257);
+
+        BigFloat product = BigFloat(a, 200) * BigFloat(b, 200);
+        ASSERT_EQ(BigFloat(BigFloat(a, 200).to_bignum() * BigFloat(b, 200).to_bignum(), 200), product);
+    }
+}
+
+TEST(BigFloatTest, DivisionRoundsCorrectly) {
+    ASSERT_EQ(BigFloat(Bignum(11), -5, 4), BigFloat(Bignum(1), 4) / BigFloat(Bignum(3), 4));
+    ASSERT_EQ(BigFloat(Bignum(-11), -5, 4), BigFloat(Bignum(-1), 4) / BigFloat(Bignum(3), 4));
+    ASSERT_THROW(BigFloat(Bignum(1)) / BigFloat(Bignum(0)), std::domain_error);
+}
+
+TEST(BigFloatTest, SquareRoots) {
+    BigFloat two(Bignum(2), 53);
+
+    ASSERT_EQ(std::sqrt(2.0), two.sqrt().to_double());
+    ASSERT_EQ(BigFloat(Bignum(12345), 300), BigFloat(Bignum(12345) * 12345, 300).sqrt());
+    ASSERT_EQ(BigFloat(Bignum(1), -50, 10), BigFloat(Bignum(1), -100, 10).sqrt());
+    ASSERT_THROW(BigFloat(Bignum(-1)).sqrt(), std::domain_error);
+}
+
+TEST(BigFloatTest, LogarithmsAndExponentials) {
+    ASSERT_EQ(M_LN2, BigFloat(Bignum(2), 53).log().to_double());
+    ASSERT_EQ(M_LN10, BigFloat(Bignum(10), 53).log().to_double());
+    ASSERT_EQ(M_E, BigFloat(Bignum(1), 53).exp().to_double());
+    ASSERT_EQ(0, BigFloat(Bignum(1), 53).log().signum());
+    ASSERT_EQ(BigFloat(Bignum(1), 53), BigFloat(Bignum(0), 53).exp());
+    ASSERT_THROW(BigFloat(Bignum(0)).log(), std::domain_error);
+}
+
+TEST(BigFloatTest, LogarithmsNearOne) {
+    BigFloat x = BigFloat(Bignum(1), 64) + BigFloat(Bignum(1), -300, 64);
+    BigFloat y(power_of_two(400) + 1, -400, 500);
+
+    ASSERT_EQ(BigFloat(Bignum(1), 64), x);
+    ASSERT_EQ(BigFloat(Bignum(1), -400, 64), y.log().with_precision(64));
+}
+
+TEST(BigFloatTest, LogarithmOfAHugeValue) {
+    BigFloat x(power_of_two(1000000), 53);
+
+    ASSERT_NEAR(1000000 * M_LN2, x.log().to_double(), 1e-9);
+}
+
+TEST(BigFloatTest, ExpUndoesLog) {
+    BigFloat x = BigFloat(Bignum(314159), 200) / BigFloat(Bignum(100000), 200);
+    BigFloat round_trip = x.log().exp();
+    BigFloat difference = round_trip - x;
+
+    ASSERT_LT(std::fabs(difference.to_double()), 1e-55);
+    ASSERT_EQ(x.with_precision(150), round_trip.with_precision(150));
+}
+
+TEST(BigFloatTest, DigitsOfEAtHighPrecision) {
+    BigFloat e = BigFloat(Bignum(1), 400).exp();
+    Bignum scale(1);
+    for (int i = 0; i < 50; ++i)
+        scale *= 10;
+
+    std::ostringstream digits;
+    digits << (e * BigFloat(scale, 400)).to_bignum();
+    ASSERT_EQ("271828182845904523536028747135266249775724709369995", digits.str());
+}
+
+TEST(BigFloatTest, Comparisons) {
+    BigFloat half(Bignum(1), -1, 10);
+    BigFloat third = BigFloat(Bignum(1), 64) / BigFloat(Bignum(3), 64);
+
+    ASSERT_LT(third, half);
+    ASSERT_GT(half, third);
+    ASSERT_LT(-half, third);
+    ASSERT_EQ(half, BigFloat(Bignum(2), -2, 100));
+    ASSERT_NE(half, third);
+}
+
+TEST(BigFloatTest, ZeroPrecisionIsRejected) {
+    ASSERT_THROW(BigFloat(Bignum(1), 0), std::invalid_argument);
+}
@@ -1,186 +1,1316 @@
 #include "Bignum.h"
+#include "BignumKernels.h"
+#include <cerrno>
 #include <cstdlib>
 #include <cmath>
 #include <algorithm>
+#include <climits>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <unistd.h>
 
 const uint64_t Bignum::BASE = UINT32_MAX + 1ULL;
 const std::size_t Bignum::BITS_IN_DIGIT = sizeof(uint32_t) * CHAR_BIT;
 
+const char* const DEFAULT_THRESHOLDS_FILE = "bignum_thresholds.conf";
+
+const std::size_t BignumThresholds::MINIMUM_KARATSUBA_DIGITS = 4;
+
+BignumThresholds::BignumThresholds() : block_add_digits(8), bulk_shift_digits(4), karatsuba_digits(40) {
+}
+
+BignumThresholds load_bignum_thresholds() {
+    BignumThresholds thresholds;
+
+    const char* path = std::getenv("BIGNUM_THRESHOLDS");
+    std::ifstream in(path != 0 ? path : DEFAULT_THRESHOLDS_FILE);
+    if (in)
+        read_bignum_thresholds(in, thresholds);
+
+    return thresholds;
+}
+
+BignumThresholds& current_bignum_thresholds() {
+    static BignumThresholds thresholds = load_bignum_thresholds();
+    return thresholds;
+}
+
+const BignumThresholds& bignum_thresholds() {
+    return current_bignum_thresholds();
+}
+
+void set_bignum_thresholds(const BignumThresholds& thresholds) {
+    current_bignum_thresholds() = thresholds;
+}
+
+// A threshold is a plain decimal count no smaller than the tier allows.
+bool parse_threshold(const std::string& text, const std::size_t minimum, std::size_t& threshold) {
+    if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos)
+        return false;
+
+    std::istringstream digits(text);
+    std::size_t value;
+    if (!(digits >> value) || value < minimum)
+        return false;
+
+    threshold = value;
+    return true;
+}
+
+// Lines of "name value"; blank lines and lines starting with # are
+// skipped.  Settings that are missing keep their current values.  If any
+// line is malformed, names an unknown setting or holds a value below its
+// tier's minimum, nothing is changed and false is returned.
+bool read_bignum_thresholds(std::istream& in, BignumThresholds& thresholds) {
+    BignumThresholds read = thresholds;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string name;
+        if (!(fields >> name) || name[0] == '#')
+            continue;
+
+        std::string value;
+        std::string rest;
+        if (!(fields >> value) || fields >> rest)
+            return false;
+
+        bool parsed;
+        if (name == "block_add_digits")
+            parsed = parse_threshold(value, 0, read.block_add_digits);
+        else if (name == "bulk_shift_digits")
+            parsed = parse_threshold(value, 0, read.bulk_shift_digits);
+        else if (name == "karatsuba_digits")
+            parsed = parse_threshold(value, BignumThresholds::MINIMUM_KARATSUBA_DIGITS, read.karatsuba_digits);
+        else
+            parsed = false;
+
+        if (!parsed)
+            return false;
+    }
+
+    thresholds = read;
+    return true;
+}
+
+void write_bignum_thresholds(std::ostream& out, const BignumThresholds& thresholds) {
+    out << "block_add_digits " << thresholds.block_add_digits << '\n'
+        << "bulk_shift_digits " << thresholds.bulk_shift_digits << '\n'
+        << "karatsuba_digits " << thresholds.karatsuba_digits << '\n';
+}
+
 uint64_t digit(const std::deque<uint32_t>& digits, std::deque<uint32_t>::size_type index) {
     return index >= digits.size() ? 0U : digits[index];
 }
 
-void strip_leading_zeros(std::deque<uint32_t>& digits) {
-    for (std::deque<uint32_t>::reverse_iterator i = digits.rbegin(); *i == 0U && digits.size() > 1;)
-        digits.erase((++i).base());
+void strip_leading_zeros(std::deque<uint32_t>& digits) {
+    for (std::deque<uint32_t>::reverse_iterator i = digits.rbegin(); *i == 0U && digits.size() > 1;)
+        digits.erase((++i).base());
+}
+
+std::deque<uint32_t> add_digitwise(const std::deque<uint32_t>& first, const std::deque<uint32_t>& second) {
+    std::deque<uint32_t>::size_type max_length = std::max(first.size(), second.size());
+    uint64_t carry(0);
+    std::deque<uint32_t> sum_digits;
+
+    for (std::deque<uint32_t>::size_type i = 0; i < max_length; ++i) {
+        uint64_t sum = digit(first, i) + digit(second, i) + carry;
+        sum_digits.push_back(sum % Bignum::BASE);
+        carry = sum / Bignum::BASE;
+    }
+
+    if (carry != 0)
+        sum_digits.push_back(carry);
+
+    strip_leading_zeros(sum_digits);
+    return sum_digits;
+}
+
+std::deque<uint32_t> subtract_digitwise(const std::deque<uint32_t>& first, const std::deque<uint32_t>& second) {
+    std::deque<uint32_t>::size_type max_length = std::max(first.size(), second.size());
+    int64_t borrow(0);
+    std::deque<uint32_t> difference_digits;
+
+    for (std::deque<uint32_t>::size_type i = 0; i < max_length; ++i) {
+        int64_t difference = digit(first, i) - digit(second, i) - borrow;
+        if (difference < 0) {
+            difference += Bignum::BASE;
+            borrow = 1;
+        } else
+            borrow = 0;
+
+        difference_digits.push_back(difference % Bignum::BASE);
+    }
+
+    strip_leading_zeros(difference_digits);
+    return difference_digits;
+}
+
+std::deque<uint32_t> multiply_schoolbook(const std::deque<uint32_t>& first, const std::deque<uint32_t>& second) {
+    std::deque<uint32_t> product_digits(first.size() + second.size(), 0U);
+
+    for (std::deque<uint32_t>::size_type i = 0; i < first.size(); ++i) {
+        uint64_t carry(0);
+
+        for (std::deque<uint32_t>::size_type j = 0; j < second.size(); ++j) {
+            uint64_t product = (uint64_t) first[i] * second[j] + product_digits[i + j] + carry;
+            product_digits[i + j] = product % Bignum::BASE;
+            carry = product / Bignum::BASE;
+        }
+
+        product_digits[i + second.size()] = carry;
+    }
+
+    strip_leading_zeros(product_digits);
+    return product_digits;
+}
+
+// Sizes the result up front and walks both operands with iterators.
+std::deque<uint32_t> add_block(const std::deque<uint32_t>& first, const std::deque<uint32_t>& second) {
+    const std::deque<uint32_t>& longer = first.size() >= second.size() ? first : second;
+    const std::deque<uint32_t>& shorter = first.size() >= second.size() ? second : first;
+    std::deque<uint32_t> sum_digits(longer.size() + 1, 0U);
+
+    uint64_t carry(0);
+    std::deque<uint32_t>::iterator out = sum_digits.begin();
+    std::deque<uint32_t>::const_iterator i = longer.begin();
+    for (std::deque<uint32_t>::const_iterator j = shorter.begin(); j != shorter.end(); ++i, ++j, ++out) {
+        uint64_t sum = (uint64_t) *i + *j + carry;
+        *out = (uint32_t) sum;
+        carry = sum >> Bignum::BITS_IN_DIGIT;
+    }
+    for (; i != longer.end(); ++i, ++out) {
+        uint64_t sum = *i + carry;
+        *out = (uint32_t) sum;
+        carry = sum >> Bignum::BITS_IN_DIGIT;
+    }
+    *out = (uint32_t) carry;
+
+    strip_leading_zeros(sum_digits);
+    return sum_digits;
+}
+
+// As add_block(), for first at least as large as second.
+std::deque<uint32_t> subtract_block(const std::deque<uint32_t>& first, const std::deque<uint32_t>& second) {
+    std::deque<uint32_t> difference_digits(first.size(), 0U);
+
+    int64_t borrow(0);
+    std::deque<uint32_t>::iterator out = difference_digits.begin();
+    std::deque<uint32_t>::const_iterator i = first.begin();
+    for (std::deque<uint32_t>::const_iterator j = second.begin(); j != second.end() && i != first.end(); ++i, ++j, ++out) {
+        int64_t difference = (int64_t) *i - *j - borrow;
+        borrow = difference < 0 ? 1 : 0;
+        *out = (uint32_t) difference;
+    }
+    for (; i != first.end(); ++i, ++out) {
+        int64_t difference = (int64_t) *i - borrow;
+        borrow = difference < 0 ? 1 : 0;
+        *out = (uint32_t) difference;
+    }
+
+    strip_leading_zeros(difference_digits);
+    return difference_digits;
+}
+
+std::deque<uint32_t> add(const std::deque<uint32_t>& first, const std::deque<uint32_t>& second) {
+    if (std::max(first.size(), second.size()) >= bignum_thresholds().block_add_digits)
+        return add_block(first, second);
+
+    return add_digitwise(first, second);
+}
+
+std::deque<uint32_t> subtract(const std::deque<uint32_t>& first, const std::deque<uint32_t>& second) {
+    if (std::max(first.size(), second.size()) >= bignum_thresholds().block_add_digits)
+        return subtract_block(first, second);
+
+    return subtract_digitwise(first, second);
+}
+
+std::deque<uint32_t> digit_range(const std::deque<uint32_t>& digits, std::deque<uint32_t>::size_type begin,
+    std::deque<uint32_t>::size_type end) {
+    begin = std::min(begin, digits.size());
+    end = std::min(end, digits.size());
+    if (begin == end)
+        return std::deque<uint32_t>(1, 0U);
+
+    std::deque<uint32_t> range(digits.begin() + begin, digits.begin() + end);
+    strip_leading_zeros(range);
+    return range;
+}
+
+void add_shifted(std::deque<uint32_t>& sum, const std::deque<uint32_t>& addend, std::deque<uint32_t>::size_type offset) {
+    if (sum.size() < addend.size() + offset)
+        sum.resize(addend.size() + offset, 0U);
+
+    uint64_t carry(0);
+    std::deque<uint32_t>::size_type i = 0;
+    for (; i < addend.size(); ++i) {
+        uint64_t total = (uint64_t) sum[i + offset] + addend[i] + carry;
+        sum[i + offset] = (uint32_t) total;
+        carry = total >> Bignum::BITS_IN_DIGIT;
+    }
+    for (i += offset; carry != 0; ++i) {
+        if (i == sum.size())
+            sum.push_back(0U);
+        uint64_t total = sum[i] + carry;
+        sum[i] = (uint32_t) total;
+        carry = total >> Bignum::BITS_IN_DIGIT;
+    }
+}
+
+std::deque<uint32_t> multiply(const std::deque<uint32_t>& first, const std::deque<uint32_t>& second);
+
+// Karatsuba: with x = x1 B^m + x0 and y = y1 B^m + y0,
+// xy = z2 B^2m + ((x0 + x1)(y0 + y1) - z2 - z0) B^m + z0,
+// where z2 = x1 y1 and z0 = x0 y0.  An operand no longer than m is
+// instead multiplied by each half of the other.  Below
+// MINIMUM_KARATSUBA_DIGITS the sums of halves need not be shorter than x,
+// so the recursion would not shrink; such operands go to schoolbook.
+std::deque<uint32_t> multiply_karatsuba(const std::deque<uint32_t>& first, const std::deque<uint32_t>& second) {
+    const std::deque<uint32_t>& longer = first.size() >= second.size() ? first : second;
+    const std::deque<uint32_t>& shorter = first.size() >= second.size() ? second : first;
+    if (longer.size() < BignumThresholds::MINIMUM_KARATSUBA_DIGITS)
+        return multiply_schoolbook(first, second);
+
+    const std::deque<uint32_t>::size_type m = longer.size() / 2;
+
+    const std::deque<uint32_t> low = digit_range(longer, 0, m);
+    const std::deque<uint32_t> high = digit_range(longer, m, longer.size());
+
+    std::deque<uint32_t> product;
+    if (shorter.size() <= m) {
+        product = multiply(low, shorter);
+        add_shifted(product, multiply(high, shorter), m);
+    } else {
+        const std::deque<uint32_t> other_low = digit_range(shorter, 0, m);
+        const std::deque<uint32_t> other_high = digit_range(shorter, m, shorter.size());
+
+        product = multiply(low, other_low);
+        const std::deque<uint32_t> high_product = multiply(high, other_high);
+        const std::deque<uint32_t> middle = subtract(
+            subtract(multiply(add(low, high), add(other_low, other_high)), high_product), product);
+
+        add_shifted(product, middle, m);
+        add_shifted(product, high_product, 2 * m);
+    }
+
+    strip_leading_zeros(product);
+    return product;
+}
+
+std::deque<uint32_t> multiply(const std::deque<uint32_t>& first, const std::deque<uint32_t>& second) {
+    if (std::min(first.size(), second.size()) >= bignum_thresholds().karatsuba_digits)
+        return multiply_karatsuba(first, second);
+
+    return multiply_schoolbook(first, second);
+}
+
+int compare_digits(const std::deque<uint32_t>& first, const std::deque<uint32_t>& second) {
+    if (first.size() != second.size())
+        return first.size() < second.size() ? -1 : 1;
+
+    // Walk down from the high end two bigits at a time.
+    std::deque<uint32_t>::const_reverse_iterator i = first.rbegin();
+    std::deque<uint32_t>::const_reverse_iterator j = second.rbegin();
+    for (std::deque<uint32_t>::size_type remaining = first.size(); remaining >= 2; remaining -= 2) {
+        uint64_t high = (uint64_t) *i++ << Bignum::BITS_IN_DIGIT;
+        uint64_t other_high = (uint64_t) *j++ << Bignum::BITS_IN_DIGIT;
+        uint64_t word = high | *i++;
+        uint64_t other_word = other_high | *j++;
+        if (word != other_word)
+            return word < other_word ? -1 : 1;
+    }
+
+    if (i != first.rend() && *i != *j)
+        return *i < *j ? -1 : 1;
+
+    return 0;
+}
+
+uint64_t native_magnitude(const int64_t value) {
+    return value < 0 ? -(uint64_t) value : value;
+}
+
+std::deque<uint32_t> native_digits(const uint64_t value) {
+    std::deque<uint32_t> digits;
+    digits.push_back((uint32_t) (value & 0x00000000FFFFFFFFULL));
+    digits.push_back((uint32_t) (value >> 32));
+    strip_leading_zeros(digits);
+    return digits;
+}
+
+uint64_t native_value(const std::deque<uint32_t>& digits) {
+    return digit(digits, 0) | (digit(digits, 1) << Bignum::BITS_IN_DIGIT);
+}
+
+int compare_native_digits(const std::deque<uint32_t>& digits, const uint64_t value) {
+    if (digits.size() > 2)
+        return 1;
+
+    uint64_t own = native_value(digits);
+    return own < value ? -1 : (own > value ? 1 : 0);
+}
+
+// Adds in place, stopping as soon as the carry dies out.
+void add_native_digits(std::deque<uint32_t>& digits, const uint64_t value) {
+    uint64_t carry = value;
+
+    for (std::deque<uint32_t>::size_type i = 0; carry != 0; ++i) {
+        if (i == digits.size())
+            digits.push_back(0U);
+
+        uint64_t sum = digits[i] + (carry & 0x00000000FFFFFFFFULL);
+        digits[i] = sum % Bignum::BASE;
+        carry = (carry >> Bignum::BITS_IN_DIGIT) + sum / Bignum::BASE;
+    }
+}
+
+// Subtracts in place from digits at least as large as value, stopping as
+// soon as the borrow dies out.
+void subtract_native_digits(std::deque<uint32_t>& digits, const uint64_t value) {
+    uint64_t borrow = value;
+
+    for (std::deque<uint32_t>::size_type i = 0; borrow != 0; ++i) {
+        uint64_t low = borrow & 0x00000000FFFFFFFFULL;
+        borrow >>= Bignum::BITS_IN_DIGIT;
+
+        if (digits[i] < low) {
+            digits[i] = digits[i] + Bignum::BASE - low;
+            ++borrow;
+        } else
+            digits[i] -= low;
+    }
+
+    strip_leading_zeros(digits);
+}
+
+std::deque<uint32_t> shift_digits_left(const std::deque<uint32_t>& digits, const unsigned int shift_amount) {
+    std::deque<uint32_t> shifted(digits);
+    shifted.push_back(0U);
+
+    if (shift_amount > 0) {
+        for (std::deque<uint32_t>::size_type i = shifted.size() - 1; i > 0; --i)
+            shifted[i] = (shifted[i] << shift_amount) | (shifted[i - 1] >> (Bignum::BITS_IN_DIGIT - shift_amount));
+        shifted[0] <<= shift_amount;
+    }
+
+    return shifted;
+}
+
+LongDivision::LongDivision(const std::deque<uint32_t>& dividend, const std::deque<uint32_t>& divisor)
+    : u(dividend), v(divisor), quotient(1, 0U), shift_amount(0), next(0) {
+    if (divisor.size() == 1 && divisor[0] == 0U)
+        throw std::domain_error("division by zero");
+
+    if (compare_digits(dividend, divisor) < 0)
+        return;
+
+    if (divisor.size() == 1) {
+        uint64_t rest(0);
+        quotient.assign(dividend.size(), 0U);
+        for (std::deque<uint32_t>::size_type i = dividend.size(); i > 0; --i) {
+            uint64_t current = (rest << Bignum::BITS_IN_DIGIT) | dividend[i - 1];
+            quotient[i - 1] = current / divisor[0];
+            rest = current % divisor[0];
+        }
+
+        u.assign(1, (uint32_t) rest);
+        return;
+    }
+
+    for (uint32_t top = divisor.back(); (top & 0x80000000U) == 0; top <<= 1)
+        ++shift_amount;
+
+    v = shift_digits_left(divisor, shift_amount);
+    v.pop_back();
+    u = shift_digits_left(dividend, shift_amount);
+    next = dividend.size() - divisor.size() + 1;
+    quotient.assign(next, 0U);
+}
+
+std::deque<uint32_t>::size_type LongDivision::remaining() const {
+    return next;
+}
+
+void LongDivision::step(std::deque<uint32_t>::size_type count) {
+    const std::deque<uint32_t>::size_type n = v.size();
+
+    for (; count > 0 && next > 0; --count) {
+        const std::deque<uint32_t>::size_type j = --next;
+        uint64_t numerator = ((uint64_t) u[j + n] << Bignum::BITS_IN_DIGIT) | u[j + n - 1];
+        uint64_t estimate = numerator / v[n - 1];
+        uint64_t rest = numerator % v[n - 1];
+
+        while (estimate >= Bignum::BASE
+            || estimate * v[n - 2] > ((rest << Bignum::BITS_IN_DIGIT) | u[j + n - 2])) {
+            --estimate;
+            rest += v[n - 1];
+            if (rest >= Bignum::BASE)
+                break;
+        }
+
+        int64_t borrow(0);
+        int64_t difference(0);
+        for (std::deque<uint32_t>::size_type i = 0; i < n; ++i) {
+            uint64_t product = estimate * v[i];
+            difference = u[i + j] - borrow - (int64_t) (product & 0xFFFFFFFFULL);
+            u[i + j] = (uint32_t) difference;
+            borrow = (int64_t) (product >> Bignum::BITS_IN_DIGIT) - (difference >> Bignum::BITS_IN_DIGIT);
+        }
+        difference = u[j + n] - borrow;
+        u[j + n] = (uint32_t) difference;
+
+        if (difference < 0) {
+            --estimate;
+            uint64_t carry(0);
+            for (std::deque<uint32_t>::size_type i = 0; i < n; ++i) {
+                uint64_t sum = (uint64_t) u[i + j] + v[i] + carry;
+                u[i + j] = (uint32_t) sum;
+                carry = sum >> Bignum::BITS_IN_DIGIT;
+            }
+            u[j + n] += carry;
+        }
+
+        quotient[j] = (uint32_t) estimate;
+    }
+}
+
+void LongDivision::finish(std::deque<uint32_t>& quotient, std::deque<uint32_t>& remainder) {
+    const std::deque<uint32_t>::size_type n = std::min(v.size(), u.size());
+
+    strip_leading_zeros(this->quotient);
+    quotient.swap(this->quotient);
+
+    remainder.assign(u.begin(), u.begin() + n);
+    if (shift_amount > 0) {
+        for (std::deque<uint32_t>::size_type i = 0; i < n; ++i) {
+            remainder[i] >>= shift_amount;
+            if (i + 1 < n)
+                remainder[i] |= remainder[i + 1] << (Bignum::BITS_IN_DIGIT - shift_amount);
+        }
+    }
+    strip_leading_zeros(remainder);
+}
+
+void divide(const std::deque<uint32_t>& dividend, const std::deque<uint32_t>& divisor,
+    std::deque<uint32_t>& quotient, std::deque<uint32_t>& remainder) {
+    LongDivision division(dividend, divisor);
+    division.step(division.remaining());
+    division.finish(quotient, remainder);
+}
+
+// The index of the lowest non-zero digit at or above from, or
+// digits.size() if none.
+std::deque<uint32_t>::size_type lowest_nonzero_digit(const std::deque<uint32_t>& digits,
+    std::deque<uint32_t>::size_type from) {
+    std::deque<uint32_t>::size_type index = std::min(from, digits.size());
+    while (index < digits.size() && digits[index] == 0U)
+        ++index;
+    return index;
+}
+
+// digits += 2^bit, carrying only as far as it needs to.
+void add_power_of_two(std::deque<uint32_t>& digits, const uint64_t bit) {
+    uint64_t index = bit / Bignum::BITS_IN_DIGIT;
+    if (index >= digits.size())
+        digits.resize(index + 1, 0U);
+
+    uint64_t sum = (uint64_t) digits[index] + (1U << (bit % Bignum::BITS_IN_DIGIT));
+    digits[index] = (uint32_t) sum;
+    while (sum >> Bignum::BITS_IN_DIGIT != 0) {
+        if (++index == digits.size())
+            digits.push_back(0U);
+        sum = (uint64_t) digits[index] + 1;
+        digits[index] = (uint32_t) sum;
+    }
+}
+
+// digits -= 2^bit, for digits at least 2^bit, borrowing only as far as it
+// needs to.
+void subtract_power_of_two(std::deque<uint32_t>& digits, const uint64_t bit) {
+    uint64_t index = bit / Bignum::BITS_IN_DIGIT;
+    const uint32_t power = 1U << (bit % Bignum::BITS_IN_DIGIT);
+
+    bool borrow = digits[index] < power;
+    digits[index] -= power;
+    while (borrow) {
+        borrow = digits[++index] == 0U;
+        --digits[index];
+    }
+
+    strip_leading_zeros(digits);
+}
+
+// Negates a fixed-width two's-complement number in place: ~x + 1.
+void negate_words(std::deque<uint32_t>& words) {
+    uint64_t carry(1);
+    for (std::deque<uint32_t>::iterator i = words.begin(); i != words.end(); ++i) {
+        uint64_t sum = (uint64_t) (uint32_t) ~*i + carry;
+        *i = (uint32_t) sum;
+        carry = sum >> Bignum::BITS_IN_DIGIT;
+    }
+}
+
+// The signed magnitude as two's-complement words, sign-extended to length.
+std::deque<uint32_t> twos_complement(const Bignum& n, std::deque<uint32_t>::size_type length) {
+    std::deque<uint32_t> words(n.digits());
+    words.resize(length, 0U);
+    if (n.signum() < 0)
+        negate_words(words);
+
+    return words;
+}
+
+struct AndWords {
+    uint32_t operator()(uint32_t first, uint32_t second) const {
+        return first & second;
+    }
+};
+
+struct OrWords {
+    uint32_t operator()(uint32_t first, uint32_t second) const {
+        return first | second;
+    }
+};
+
+struct XorWords {
+    uint32_t operator()(uint32_t first, uint32_t second) const {
+        return first ^ second;
+    }
+};
+
+// Combines the operands a word at a time as if each were sign-extended
+// to infinity, with one spare word to carry the sign of the result.
+template <typename Operation>
+Bignum combine_words(const Bignum& first, const Bignum& second, Operation operation) {
+    std::deque<uint32_t>::size_type length = std::max(first.digits().size(), second.digits().size()) + 1;
+    std::deque<uint32_t> words = twos_complement(first, length);
+    std::deque<uint32_t> others = twos_complement(second, length);
+
+    std::deque<uint32_t>::iterator i = words.begin();
+    for (std::deque<uint32_t>::const_iterator j = others.begin(); j != others.end(); ++i, ++j)
+        *i = operation(*i, *j);
+
+    bool negative = (words.back() >> (Bignum::BITS_IN_DIGIT - 1)) != 0;
+    if (negative)
+        negate_words(words);
+    strip_leading_zeros(words);
+
+    if (words.size() == 1 && words[0] == 0U)
+        return Bignum(0);
+    return Bignum(words, negative ? -1 : 1);
+}
+
+Bignum::Bignum(const int64_t value) : store(), lowest_digit(0) {
+    sign = value < 0 ? -1 : (value == 0 ? 0 : 1);
+    store = native_digits(native_magnitude(value));
+    lowest_digit = lowest_nonzero_digit(store, 0);
+}
+
+Bignum::Bignum(const std::deque<uint32_t>& digits, const int sign)
+    : store(digits), sign(sign), lowest_digit(lowest_nonzero_digit(digits, 0)) {
+}
+
+Bignum::Bignum(const Bignum& other)
+    : store(other.store), sign(other.sign), lowest_digit(other.lowest_digit) {
+}
+
+Bignum& Bignum::operator=(const Bignum& other) {
+    if (this != &other) {
+        store = other.store;
+        sign = other.sign;
+        lowest_digit = other.lowest_digit;
+    }
+
+    return *this;
+}
+
+int Bignum::compare(const Bignum& other) const {
+    if (sign != other.sign)
+        return sign < other.sign ? -1 : 1;
+
+    return sign * compare_digits(store, other.store);
+}
+
+int Bignum::compare(const int value) const {
+    return compare((long long) value);
+}
+
+int Bignum::compare(const unsigned int value) const {
+    return compare((unsigned long long) value);
+}
+
+int Bignum::compare(const long value) const {
+    return compare((long long) value);
+}
+
+int Bignum::compare(const unsigned long value) const {
+    return compare((unsigned long long) value);
+}
+
+int Bignum::compare(const long long value) const {
+    return compare_native(native_magnitude(value), value < 0 ? -1 : 1);
+}
+
+int Bignum::compare(const unsigned long long value) const {
+    return compare_native(value, 1);
+}
+
+int Bignum::compare_native(const uint64_t magnitude, const int magnitude_sign) const {
+    int value_sign = magnitude == 0 ? 0 : magnitude_sign;
+    if (sign != value_sign)
+        return sign < value_sign ? -1 : 1;
+
+    return sign * compare_native_digits(store, magnitude);
+}
+
+bool Bignum::equal(const Bignum& other) const {
+    return compare(other) == 0;
+}
+
+bool Bignum::less(const Bignum& other) const {
+    return compare(other) < 0;
+}
+
+uint64_t Bignum::hash() const {
+    uint64_t hash = 0xCBF29CE484222325ULL ^ (uint64_t) (sign + 1);
+
+    for (std::deque<uint32_t>::const_iterator i = store.begin(); i != store.end(); ++i)
+        hash = (hash ^ *i) * 0x00000100000001B3ULL;
+
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+int Bignum::signum() const {
+    return sign;
+}
+
+uint64_t Bignum::bit_length() const {
+    if (sign == 0)
+        return 0;
+
+    uint64_t length = (store.size() - 1) * Bignum::BITS_IN_DIGIT;
+    for (uint32_t top = store.back(); top != 0; top >>= 1)
+        ++length;
+
+    return length;
+}
+
+uint32_t Bignum::remainder(const uint32_t divisor) const {
+    uint64_t remainder(0);
+
+    for (std::deque<uint32_t>::const_reverse_iterator i = store.rbegin(); i != store.rend(); ++i)
+        remainder = ((remainder << Bignum::BITS_IN_DIGIT) | *i) % divisor;
+
+    return remainder;
+}
+
+bool Bignum::test_bit(const uint64_t bit) const {
+    const uint64_t index = bit / Bignum::BITS_IN_DIGIT;
+    if (index >= store.size())
+        return sign < 0;
+
+    uint32_t word = store[index];
+    if (sign < 0) {
+        // -m is ~(m - 1), and m - 1 differs from m only up to m's lowest
+        // non-zero digit: it is one less there and all ones below.
+        word = index < lowest_digit ? 0U : ~(index == lowest_digit ? word - 1 : word);
+    }
+
+    return (word >> (bit % Bignum::BITS_IN_DIGIT) & 1U) != 0;
+}
+
+// On a negative value, setting a clear bit adds 2^bit, so the magnitude
+// loses 2^bit; the borrow stops at its lowest non-zero digit.  Either way
+// only digits from the bit's own upward change, so the search for the
+// new lowest non-zero digit starts there or at the old one.
+void Bignum::set_bit(const uint64_t bit) {
+    const uint64_t index = bit / Bignum::BITS_IN_DIGIT;
+
+    if (sign < 0) {
+        if (!test_bit(bit)) {
+            subtract_power_of_two(store, bit);
+            reconcile_above(std::min<uint64_t>(lowest_digit, index));
+        }
+        return;
+    }
+
+    if (index >= store.size())
+        store.resize(index + 1, 0U);
+    store[index] |= 1U << (bit % Bignum::BITS_IN_DIGIT);
+    lowest_digit = sign == 0 ? index : std::min<uint64_t>(lowest_digit, index);
+    sign = 1;
+}
+
+// Likewise clearing a set bit of a negative value grows its magnitude by
+// 2^bit.
+void Bignum::clear_bit(const uint64_t bit) {
+    const uint64_t index = bit / Bignum::BITS_IN_DIGIT;
+
+    if (sign < 0) {
+        if (test_bit(bit)) {
+            add_power_of_two(store, bit);
+            reconcile_above(std::min<uint64_t>(lowest_digit, index));
+        }
+        return;
+    }
+
+    if (index >= store.size())
+        return;
+    store[index] &= ~(1U << (bit % Bignum::BITS_IN_DIGIT));
+
+    strip_leading_zeros(store);
+    reconcile_above(std::min<uint64_t>(lowest_digit, index));
+}
+
+const std::deque<uint32_t>& Bignum::digits() const {
+    return store;
+}
+
+Bignum Bignum::abs() const {
+    return sign >= 0 ? Bignum(*this) : Bignum(store, 1);
+}
+
+bool operator==(const Bignum& left, const Bignum& right) {
+    return left.equal(right);
+}
+
+bool operator!=(const Bignum& left, const Bignum& right) {
+    return !(left == right);
+}
+
+bool operator<(const Bignum& left, const Bignum& right) {
+    return left.less(right);
+}
+
+bool operator<=(const Bignum& left, const Bignum& right) {
+    return !(left > right);
+}
+
+bool operator>(const Bignum& left, const Bignum& right) {
+    return right < left;
+}
+
+bool operator>=(const Bignum& left, const Bignum& right) {
+    return right <= left;
+}
+
+bool operator==(const Bignum& left, const int right) {
+    return left.compare(right) == 0;
+}
+
+bool operator==(const Bignum& left, const unsigned int right) {
+    return left.compare(right) == 0;
+}
+
+bool operator==(const Bignum& left, const long right) {
+    return left.compare(right) == 0;
+}
+
+bool operator==(const Bignum& left, const unsigned long right) {
+    return left.compare(right) == 0;
+}
+
+bool operator==(const Bignum& left, const long long right) {
+    return left.compare(right) == 0;
+}
+
+bool operator==(const Bignum& left, const unsigned long long right) {
+    return left.compare(right) == 0;
+}
+
+bool operator!=(const Bignum& left, const int right) {
+    return left.compare(right) != 0;
+}
+
+bool operator!=(const Bignum& left, const unsigned int right) {
+    return left.compare(right) != 0;
+}
+
+bool operator!=(const Bignum& left, const long right) {
+    return left.compare(right) != 0;
+}
+
+bool operator!=(const Bignum& left, const unsigned long right) {
+    return left.compare(right) != 0;
+}
+
+bool operator!=(const Bignum& left, const long long right) {
+    return left.compare(right) != 0;
+}
+
+bool operator!=(const Bignum& left, const unsigned long long right) {
+    return left.compare(right) != 0;
+}
+
+bool operator<(const Bignum& left, const int right) {
+    return left.compare(right) < 0;
+}
+
+bool operator<(const Bignum& left, const unsigned int right) {
+    return left.compare(right) < 0;
+}
+
+bool operator<(const Bignum& left, const long right) {
+    return left.compare(right) < 0;
+}
+
+bool operator<(const Bignum& left, const unsigned long right) {
+    return left.compare(right) < 0;
+}
+
+bool operator<(const Bignum& left, const long long right) {
+    return left.compare(right) < 0;
+}
+
+bool operator<(const Bignum& left, const unsigned long long right) {
+    return left.compare(right) < 0;
+}
+
+bool operator<=(const Bignum& left, const int right) {
+    return left.compare(right) <= 0;
+}
+
+bool operator<=(const Bignum& left, const unsigned int right) {
+    return left.compare(right) <= 0;
+}
+
+bool operator<=(const Bignum& left, const long right) {
+    return left.compare(right) <= 0;
+}
+
+bool operator<=(const Bignum& left, const unsigned long right) {
+    return left.compare(right) <= 0;
+}
+
+bool operator<=(const Bignum& left, const long long right) {
+    return left.compare(right) <= 0;
+}
+
+bool operator<=(const Bignum& left, const unsigned long long right) {
+    return left.compare(right) <= 0;
+}
+
+bool operator>(const Bignum& left, const int right) {
+    return left.compare(right) > 0;
+}
+
+bool operator>(const Bignum& left, const unsigned int right) {
+    return left.compare(right) > 0;
+}
+
+bool operator>(const Bignum& left, const long right) {
+    return left.compare(right) > 0;
+}
+
+bool operator>(const Bignum& left, const unsigned long right) {
+    return left.compare(right) > 0;
+}
+
+bool operator>(const Bignum& left, const long long right) {
+    return left.compare(right) > 0;
+}
+
+bool operator>(const Bignum& left, const unsigned long long right) {
+    return left.compare(right) > 0;
+}
+
+bool operator>=(const Bignum& left, const int right) {
+    return left.compare(right) >= 0;
+}
+
+bool operator>=(const Bignum& left, const unsigned int right) {
+    return left.compare(right) >= 0;
+}
+
+bool operator>=(const Bignum& left, const long right) {
+    return left.compare(right) >= 0;
+}
+
+bool operator>=(const Bignum& left, const unsigned long right) {
+    return left.compare(right) >= 0;
+}
+
+bool operator>=(const Bignum& left, const long long right) {
+    return left.compare(right) >= 0;
+}
+
+bool operator>=(const Bignum& left, const unsigned long long right) {
+    return left.compare(right) >= 0;
+}
+
+Bignum operator+(const Bignum& left, const Bignum& right) {
+    return Bignum(left) += right;
+}
+
+const Bignum& Bignum::operator+=(const Bignum& other) {
+    if (other.sign == 0)
+        return *this;
+
+    Bignum this_abs = abs();
+    Bignum other_abs = other.abs();
+
+    if (sign == other.sign)
+        store = add(this_abs.store, other_abs.store);
+    else {
+        if (this_abs > other_abs)
+            store = subtract(this_abs.store, other_abs.store);
+        else {
+            store = subtract(other_abs.store, this_abs.store);
+            sign = other.sign;
+        }
+    }
+
+    reconcile();
+
+    return *this;
+}
+
+Bignum operator-(const Bignum& left, const Bignum& right) {
+    return Bignum(left) -= right;
+}
+
+const Bignum& Bignum::operator-=(const Bignum& other) {
+    if (other.sign == 0)
+        return *this;
+    if (sign == 0) {
+        store = other.store;
+        sign = -other.sign;
+        lowest_digit = other.lowest_digit;
+        return *this;
+    }
+
+    Bignum this_abs = abs();
+    Bignum other_abs = other.abs();
+
+    if (sign != other.sign)
+        store = add(this_abs.store, other_abs.store);
+    else {
+        if (this_abs > other_abs)
+            store = subtract(this_abs.store, other_abs.store);
+        else {
+            store = subtract(other_abs.store, this_abs.store);
+            sign = -sign;
+        }
+    }
+
+    reconcile();
+
+    return *this;
+}
+
+Bignum operator*(const Bignum& left, const Bignum& right) {
+    return Bignum(left) *= right;
+}
+
+const Bignum& Bignum::operator*=(const Bignum& other) {
+    store = multiply(store, other.store);
+    sign *= other.sign;
+
+    reconcile();
+
+    return *this;
+}
+
+Bignum operator/(const Bignum& left, const Bignum& right) {
+    return Bignum(left) /= right;
+}
+
+const Bignum& Bignum::operator/=(const Bignum& other) {
+    std::deque<uint32_t> quotient_digits;
+    std::deque<uint32_t> remainder_digits;
+    divide(store, other.store, quotient_digits, remainder_digits);
+    store.swap(quotient_digits);
+    sign *= other.sign;
+
+    reconcile();
+
+    return *this;
+}
+
+Bignum operator%(const Bignum& left, const Bignum& right) {
+    return Bignum(left) %= right;
+}
+
+const Bignum& Bignum::operator%=(const Bignum& other) {
+    std::deque<uint32_t> quotient_digits;
+    std::deque<uint32_t> remainder_digits;
+    divide(store, other.store, quotient_digits, remainder_digits);
+    store.swap(remainder_digits);
+
+    reconcile();
+
+    return *this;
 }
 
-std::deque<uint32_t> add(const std::deque<uint32_t>& first, const std::deque<uint32_t>& second) {
-    std::deque<uint32_t>::size_type max_length = std::max(first.size(), second.size());
-    uint64_t carry(0);
-    std::deque<uint32_t> sum_digits;
+Bignum operator+(const Bignum& left, const int right) {
+    return Bignum(left) += right;
+}
 
-    for (std::deque<uint32_t>::size_type i = 0; i < max_length; ++i) {
-        uint64_t sum = digit(first, i) + digit(second, i) + carry;
-        sum_digits.push_back(sum % Bignum::BASE);
-        carry = sum / Bignum::BASE;
-    }
+Bignum operator+(const Bignum& left, const unsigned int right) {
+    return Bignum(left) += right;
+}
 
-    if (carry != 0)
-        sum_digits.push_back(carry);
+Bignum operator+(const Bignum& left, const long right) {
+    return Bignum(left) += right;
+}
 
-    strip_leading_zeros(sum_digits);
-    return sum_digits;
+Bignum operator+(const Bignum& left, const unsigned long right) {
+    return Bignum(left) += right;
 }
 
-std::deque<uint32_t> subtract(const std::deque<uint32_t>& first, const std::deque<uint32_t>& second) {
-    std::deque<uint32_t>::size_type max_length = std::max(first.size(), second.size());
-    int64_t borrow(0);
-    std::deque<uint32_t> difference_digits;
+Bignum operator+(const Bignum& left, const long long right) {
+    return Bignum(left) += right;
+}
 
-    for (std::deque<uint32_t>::size_type i = 0; i < max_length; ++i) {
-        int64_t difference = digit(first, i) - digit(second, i) - borrow;
-        if (difference < 0) {
-            difference += Bignum::BASE;
-            borrow = 1;
-        } else
-            borrow = 0;
+Bignum operator+(const Bignum& left, const unsigned long long right) {
+    return Bignum(left) += right;
+}
 
-        difference_digits.push_back(difference % Bignum::BASE);
-    }
+Bignum operator-(const Bignum& left, const int right) {
+    return Bignum(left) -= right;
+}
 
-    strip_leading_zeros(difference_digits);
-    return difference_digits;
+Bignum operator-(const Bignum& left, const unsigned int right) {
+    return Bignum(left) -= right;
 }
 
-Bignum::Bignum(const int64_t value) : store() {
-    sign = value < 0 ? -1 : (value == 0 ? 0 : 1);
-    uint64_t no_sign = ::abs(value);
-    store.push_back((uint32_t) (no_sign & 0x00000000FFFFFFFFULL));
-    store.push_back((uint32_t) (no_sign >> 32));
-    strip_leading_zeros(store);
+Bignum operator-(const Bignum& left, const long right) {
+    return Bignum(left) -= right;
 }
 
-Bignum::Bignum(const std::deque<uint32_t>& digits, const int sign)
-    : store(digits), sign(sign) {
+Bignum operator-(const Bignum& left, const unsigned long right) {
+    return Bignum(left) -= right;
 }
 
-Bignum::Bignum(const Bignum& other)
-    : store(other.store), sign(other.sign) {
+Bignum operator-(const Bignum& left, const long long right) {
+    return Bignum(left) -= right;
 }
 
-Bignum& Bignum::operator=(const Bignum& other) {
-    if (this != &other) {
-        store = other.store;
-        sign = other.sign;
-    }
+Bignum operator-(const Bignum& left, const unsigned long long right) {
+    return Bignum(left) -= right;
+}
 
-    return *this;
+Bignum operator*(const Bignum& left, const int right) {
+    return Bignum(left) *= right;
 }
 
-bool Bignum::equal(const Bignum& other) const {
-    return store == other.store && sign == other.sign;
+Bignum operator*(const Bignum& left, const unsigned int right) {
+    return Bignum(left) *= right;
 }
 
-bool Bignum::less(const Bignum& other) const {
-    if (sign < other.sign)
-        return true;
+Bignum operator*(const Bignum& left, const long right) {
+    return Bignum(left) *= right;
+}
 
-    if (store.size() < other.store.size())
-        return true;
+Bignum operator*(const Bignum& left, const unsigned long right) {
+    return Bignum(left) *= right;
+}
 
-    for (int i = store.size() - 1; i >= 0; --i) {
-        if (sign < 0 ? store[i] > other.store[i] : store[i] < other.store[i])
-            return true;
-    }
+Bignum operator*(const Bignum& left, const long long right) {
+    return Bignum(left) *= right;
+}
 
-    return false;
+Bignum operator*(const Bignum& left, const unsigned long long right) {
+    return Bignum(left) *= right;
 }
 
-int Bignum::signum() const {
-    return sign;
+Bignum operator/(const Bignum& left, const int right) {
+    return Bignum(left) /= right;
 }
 
-Bignum Bignum::abs() const {
-    return sign >= 0 ? Bignum(*this) : Bignum(store, 1);
+Bignum operator/(const Bignum& left, const unsigned int right) {
+    return Bignum(left) /= right;
 }
 
-bool operator==(const Bignum& left, const Bignum& right) {
-    return left.equal(right);
+Bignum operator/(const Bignum& left, const long right) {
+    return Bignum(left) /= right;
 }
 
-bool operator!=(const Bignum& left, const Bignum& right) {
-    return !(left == right);
+Bignum operator/(const Bignum& left, const unsigned long right) {
+    return Bignum(left) /= right;
 }
 
-bool operator<(const Bignum& left, const Bignum& right) {
-    return left.less(right);
+Bignum operator/(const Bignum& left, const long long right) {
+    return Bignum(left) /= right;
 }
 
-bool operator<=(const Bignum& left, const Bignum& right) {
-    return !(left > right);
+Bignum operator/(const Bignum& left, const unsigned long long right) {
+    return Bignum(left) /= right;
 }
 
-bool operator>(const Bignum& left, const Bignum& right) {
-    return right < left;
+const Bignum& Bignum::operator+=(const int value) {
+    return *this += (long long) value;
 }
 
-bool operator>=(const Bignum& left, const Bignum& right) {
-    return right <= left;
+const Bignum& Bignum::operator+=(const unsigned int value) {
+    return *this += (unsigned long long) value;
 }
 
-Bignum operator+(const Bignum& left, const Bignum& right) {
-    return Bignum(left) += right;
+const Bignum& Bignum::operator+=(const long value) {
+    return *this += (long long) value;
 }
 
-const Bignum& Bignum::operator+=(const Bignum& other) {
-    if (other.sign == 0)
-        return *this;
+const Bignum& Bignum::operator+=(const unsigned long value) {
+    return *this += (unsigned long long) value;
+}
 
-    Bignum this_abs = abs();
-    Bignum other_abs = other.abs();
+const Bignum& Bignum::operator+=(const long long value) {
+    add_native(native_magnitude(value), value < 0 ? -1 : 1);
+    return *this;
+}
 
-    if (sign == other.sign)
-        store = add(this_abs.store, other_abs.store);
-    else {
-        if (this_abs > other_abs)
-            store = subtract(this_abs.store, other_abs.store);
-        else {
-            store = subtract(other_abs.store, this_abs.store);
-            sign = other.sign;
-        }
-    }
+const Bignum& Bignum::operator+=(const unsigned long long value) {
+    add_native(value, 1);
+    return *this;
+}
+
+const Bignum& Bignum::operator-=(const int value) {
+    return *this -= (long long) value;
+}
+
+const Bignum& Bignum::operator-=(const unsigned int value) {
+    return *this -= (unsigned long long) value;
+}
+
+const Bignum& Bignum::operator-=(const long value) {
+    return *this -= (long long) value;
+}
 
-    reconcile_sign_of_zero();
+const Bignum& Bignum::operator-=(const unsigned long value) {
+    return *this -= (unsigned long long) value;
+}
 
+const Bignum& Bignum::operator-=(const long long value) {
+    add_native(native_magnitude(value), value < 0 ? 1 : -1);
     return *this;
 }
 
-Bignum operator-(const Bignum& left, const Bignum& right) {
-    return Bignum(left) -= right;
+const Bignum& Bignum::operator-=(const unsigned long long value) {
+    add_native(value, -1);
+    return *this;
 }
 
-const Bignum& Bignum::operator-=(const Bignum& other) {
-    if (other.sign == 0)
-        return *this;
+const Bignum& Bignum::operator*=(const int value) {
+    return *this *= (long long) value;
+}
 
-    Bignum this_abs = abs();
-    Bignum other_abs = other.abs();
+const Bignum& Bignum::operator*=(const unsigned int value) {
+    return *this *= (unsigned long long) value;
+}
 
-    if (sign != other.sign)
-        store = add(this_abs.store, other_abs.store);
+const Bignum& Bignum::operator*=(const long value) {
+    return *this *= (long long) value;
+}
+
+const Bignum& Bignum::operator*=(const unsigned long value) {
+    return *this *= (unsigned long long) value;
+}
+
+const Bignum& Bignum::operator*=(const long long value) {
+    multiply_native(native_magnitude(value), value < 0 ? -1 : 1);
+    return *this;
+}
+
+const Bignum& Bignum::operator*=(const unsigned long long value) {
+    multiply_native(value, 1);
+    return *this;
+}
+
+const Bignum& Bignum::operator/=(const int value) {
+    return *this /= (long long) value;
+}
+
+const Bignum& Bignum::operator/=(const unsigned int value) {
+    return *this /= (unsigned long long) value;
+}
+
+const Bignum& Bignum::operator/=(const long value) {
+    return *this /= (long long) value;
+}
+
+const Bignum& Bignum::operator/=(const unsigned long value) {
+    return *this /= (unsigned long long) value;
+}
+
+const Bignum& Bignum::operator/=(const long long value) {
+    divide_native(native_magnitude(value), value < 0 ? -1 : 1);
+    return *this;
+}
+
+const Bignum& Bignum::operator/=(const unsigned long long value) {
+    divide_native(value, 1);
+    return *this;
+}
+
+void Bignum::add_native(const uint64_t magnitude, const int magnitude_sign) {
+    if (magnitude == 0)
+        return;
+
+    if (sign == 0 || sign == magnitude_sign) {
+        add_native_digits(store, magnitude);
+        sign = magnitude_sign;
+    } else if (compare_native_digits(store, magnitude) >= 0)
+        subtract_native_digits(store, magnitude);
     else {
-        if (this_abs > other_abs)
-            store = subtract(this_abs.store, other_abs.store);
-        else {
-            store = subtract(other_abs.store, this_abs.store);
-            sign = -sign;
+        store = native_digits(magnitude - native_value(store));
+        sign = magnitude_sign;
+    }
+
+    reconcile();
+}
+
+void Bignum::multiply_native(const uint64_t magnitude, const int magnitude_sign) {
+    if (magnitude > UINT32_MAX)
+        store = multiply(store, native_digits(magnitude));
+    else {
+        uint64_t carry(0);
+        for (std::deque<uint32_t>::iterator i = store.begin(); i != store.end(); ++i) {
+            uint64_t product = *i * magnitude + carry;
+            *i = product % Bignum::BASE;
+            carry = product / Bignum::BASE;
         }
+
+        if (carry != 0)
+            store.push_back(carry);
+        strip_leading_zeros(store);
     }
 
-    reconcile_sign_of_zero();
+    sign *= magnitude_sign;
 
-    return *this;
+    reconcile();
+}
+
+void Bignum::divide_native(const uint64_t magnitude, const int magnitude_sign) {
+    if (magnitude == 0)
+        throw std::domain_error("division by zero");
+
+    if (magnitude > UINT32_MAX) {
+        std::deque<uint32_t> quotient_digits;
+        std::deque<uint32_t> remainder_digits;
+        divide(store, native_digits(magnitude), quotient_digits, remainder_digits);
+        store.swap(quotient_digits);
+    } else {
+        uint64_t rest(0);
+        for (std::deque<uint32_t>::reverse_iterator i = store.rbegin(); i != store.rend(); ++i) {
+            uint64_t current = (rest << Bignum::BITS_IN_DIGIT) | *i;
+            *i = current / magnitude;
+            rest = current % magnitude;
+        }
+
+        strip_leading_zeros(store);
+    }
+
+    sign *= magnitude_sign;
+
+    reconcile();
 }
 
 Bignum operator>>(const Bignum& n, const unsigned int increment) {
@@ -191,17 +1321,27 @@ const Bignum& Bignum::operator>>=(const unsigned int increment) {
     uint32_t leading(0);
     uint32_t trailing(0);
 
+    if (increment / Bignum::BITS_IN_DIGIT >= store.size()) {
+        store.assign(1, 0U);
+        sign = 0;
+        reconcile();
+        return *this;
+    }
+
     store.erase(store.begin(), store.begin() + (increment / Bignum::BITS_IN_DIGIT));
 
     unsigned int shift_amount = increment % Bignum::BITS_IN_DIGIT;
-    for (std::deque<uint32_t>::reverse_iterator i = store.rbegin(); i != store.rend(); ++i) {
-        trailing = *i & ((1 << shift_amount) - 1);
-        *i >>= shift_amount;
-        *i |= leading;
-        leading = trailing << (Bignum::BITS_IN_DIGIT - shift_amount);
+    if (shift_amount > 0) {
+        for (std::deque<uint32_t>::reverse_iterator i = store.rbegin(); i != store.rend(); ++i) {
+            trailing = *i & ((1 << shift_amount) - 1);
+            *i >>= shift_amount;
+            *i |= leading;
+            leading = trailing << (Bignum::BITS_IN_DIGIT - shift_amount);
+        }
     }
 
-    reconcile_sign_of_zero();
+    strip_leading_zeros(store);
+    reconcile();
 
     return *this;
 }
@@ -214,6 +1354,9 @@ const Bignum& Bignum::operator<<=(const unsigned int increment) {
     uint32_t leading(0);
     uint32_t trailing(0);
 
+    if (sign == 0)
+        return *this;
+
     unsigned int number_of_trailing_zeros = increment / Bignum::BITS_IN_DIGIT;
 
     unsigned int shift_amount = increment % Bignum::BITS_IN_DIGIT;
@@ -229,14 +1372,128 @@ const Bignum& Bignum::operator<<=(const unsigned int increment) {
     if (trailing != 0)
         store.push_back(trailing);
 
-    for (unsigned int i = 0; i < number_of_trailing_zeros; ++i)
-        store.push_front(0x0U);
+    if (number_of_trailing_zeros >= bignum_thresholds().bulk_shift_digits)
+        store.insert(store.begin(), number_of_trailing_zeros, 0x0U);
+    else {
+        for (unsigned int i = 0; i < number_of_trailing_zeros; ++i)
+            store.push_front(0x0U);
+    }
+
+    reconcile();
+
+    return *this;
+}
+
+Bignum operator&(const Bignum& left, const Bignum& right) {
+    return Bignum(left) &= right;
+}
+
+Bignum operator|(const Bignum& left, const Bignum& right) {
+    return Bignum(left) |= right;
+}
+
+Bignum operator^(const Bignum& left, const Bignum& right) {
+    return Bignum(left) ^= right;
+}
+
+const Bignum& Bignum::operator&=(const Bignum& other) {
+    if (sign < 0 || other.sign < 0)
+        return *this = combine_words(*this, other, AndWords());
+
+    if (store.size() > other.store.size())
+        store.resize(other.store.size());
+    std::deque<uint32_t>::const_iterator j = other.store.begin();
+    for (std::deque<uint32_t>::iterator i = store.begin(); i != store.end(); ++i, ++j)
+        *i &= *j;
+
+    strip_leading_zeros(store);
+    reconcile();
+
+    return *this;
+}
+
+const Bignum& Bignum::operator|=(const Bignum& other) {
+    if (sign < 0 || other.sign < 0)
+        return *this = combine_words(*this, other, OrWords());
+
+    if (store.size() < other.store.size())
+        store.resize(other.store.size(), 0U);
+    std::deque<uint32_t>::iterator i = store.begin();
+    for (std::deque<uint32_t>::const_iterator j = other.store.begin(); j != other.store.end(); ++i, ++j)
+        *i |= *j;
+
+    sign = std::max(sign, other.sign);
+    reconcile();
+
+    return *this;
+}
+
+const Bignum& Bignum::operator^=(const Bignum& other) {
+    if (sign < 0 || other.sign < 0)
+        return *this = combine_words(*this, other, XorWords());
+
+    if (store.size() < other.store.size())
+        store.resize(other.store.size(), 0U);
+    std::deque<uint32_t>::iterator i = store.begin();
+    for (std::deque<uint32_t>::const_iterator j = other.store.begin(); j != other.store.end(); ++i, ++j)
+        *i ^= *j;
 
-    reconcile_sign_of_zero();
+    strip_leading_zeros(store);
+    sign = 1;
+    reconcile();
 
     return *this;
 }
 
+// ~x = -x - 1 in two's complement.
+Bignum Bignum::operator~() const {
+    return -*this - 1;
+}
+
+Bignum integer_square_root(const Bignum& n) {
+    if (n.signum() < 0)
+        throw std::domain_error("square root of a negative number");
+    if (n < 2)
+        return n;
+
+    // Newton's method from above decreases until it reaches the floor.
+    Bignum x = Bignum(1) << (unsigned int) ((n.bit_length() + 1) / 2);
+    for (;;) {
+        Bignum y = (x + n / x) >> 1;
+        if (y >= x)
+            return x;
+        x = y;
+    }
+}
+
+// Right-to-left binary powering.
+Bignum power_of(const Bignum& base, uint64_t exponent) {
+    Bignum result(1);
+    Bignum square(base);
+
+    for (; exponent != 0; exponent >>= 1) {
+        if (exponent & 1)
+            result *= square;
+        if (exponent > 1)
+            square *= square;
+    }
+
+    return result;
+}
+
+// base^exponent mod modulus, for word-sized operands.
+uint32_t word_power_mod(uint64_t base, uint64_t exponent, const uint32_t modulus) {
+    uint64_t result = 1 % modulus;
+
+    for (base %= modulus; exponent != 0; exponent >>= 1) {
+        if (exponent & 1)
+            result = result * base % modulus;
+        base = base * base % modulus;
+    }
+
+    return result;
+}
+
 Bignum Bignum::operator-() const {
     return Bignum(store, -sign);
 }
@@ -263,17 +1520,120 @@ Bignum operator--(Bignum& n, int) {
     return old;
 }
 
-void Bignum::reconcile_sign_of_zero() {
+// Brings sign and lowest_digit back in line with store once it changes.
+void Bignum::reconcile() {
+    reconcile_above(0);
+}
+
+// Likewise, when the digits below zero_digits are known to be zero.
+void Bignum::reconcile_above(const std::deque<uint32_t>::size_type zero_digits) {
     if (store.size() == 1 && store[0] == 0U)
         sign = 0;
+    lowest_digit = lowest_nonzero_digit(store, zero_digits);
 }
 
-std::ostream& operator<<(std::ostream& out, const Bignum& n) {
-    out << "sign: " << n.sign << std::endl;
-    out << "digits: " << std::endl;
+class StreamDecimalSink : public DecimalSink {
+    public:
+        StreamDecimalSink(std::ostream& out) : out(out) {
+        }
+
+    protected:
+        void emit(const char* digits, std::string::size_type count) {
+            out.write(digits, count);
+        }
+
+    private:
+        std::ostream& out;
+};
+
+class FileDescriptorDecimalSink : public DecimalSink {
+    public:
+        FileDescriptorDecimalSink(int fd) : fd(fd) {
+        }
+
+    protected:
+        void emit(const char* digits, std::string::size_type count) {
+            while (count > 0) {
+                ssize_t written = ::write(fd, digits, count);
+                if (written < 0 && errno == EINTR)
+                    continue;
+                if (written < 0)
+                    throw std::runtime_error("could not write decimal digits");
+
+                digits += written;
+                count -= written;
+            }
+        }
+
+    private:
+        int fd;
+};
+
+// Writes n, which is below powers[level]^2, depth-first: the digits of
+// n / powers[level], then those of n % powers[level] padded to full width.
+// Only one quotient or remainder per level is alive at a time.
+void write_decimal_digits(const std::deque<uint32_t>& n, const std::vector<std::deque<uint32_t> >& powers,
+    int level, bool padded, DecimalSink& sink) {
+    if (padded && n.size() == 1 && n[0] == 0U) {
+        sink.put_zeros(DECIMAL_DIGITS_IN_BIGIT << (level + 1));
+        return;
+    }
 
-    for (std::deque<uint32_t>::size_type i = 0; i != n.store.size(); ++i)
-        out << i << ": " << std::hex << n.store[i] << std::endl;
+    if (level < 0) {
+        char digits[DECIMAL_DIGITS_IN_BIGIT];
+        unsigned int start = DECIMAL_DIGITS_IN_BIGIT;
+        for (uint32_t rest = n[0]; rest != 0 || start == DECIMAL_DIGITS_IN_BIGIT; rest /= 10)
+            digits[--start] = '0' + rest % 10;
+        while (padded && start > 0)
+            digits[--start] = '0';
 
+        sink.put(digits + start, DECIMAL_DIGITS_IN_BIGIT - start);
+        return;
+    }
+
+    if (!padded && compare_digits(n, powers[level]) < 0) {
+        write_decimal_digits(n, powers, level - 1, false, sink);
+        return;
+    }
+
+    std::deque<uint32_t> quotient;
+    std::deque<uint32_t> remainder;
+    divide(n, powers[level], quotient, remainder);
+
+    write_decimal_digits(quotient, powers, level - 1, padded, sink);
+    std::deque<uint32_t>().swap(quotient);
+    write_decimal_digits(remainder, powers, level - 1, true, sink);
+}
+
+void write_decimal(const Bignum& n, DecimalSink& sink) {
+    if (n.signum() < 0)
+        sink.put("-", 1);
+
+    // powers[i] is 10^(9 * 2^i); stop once the next square would exceed n.
+    std::vector<std::deque<uint32_t> > powers;
+    powers.push_back(std::deque<uint32_t>(1, DECIMAL_BIGIT));
+    while (compare_digits(powers.back(), n.digits()) <= 0) {
+        std::deque<uint32_t> square = multiply(powers.back(), powers.back());
+        if (compare_digits(square, n.digits()) > 0)
+            break;
+        powers.push_back(square);
+    }
+
+    write_decimal_digits(n.digits(), powers, powers.size() - 1, false, sink);
+    sink.flush();
+}
+
+void write_decimal(std::ostream& out, const Bignum& n) {
+    StreamDecimalSink sink(out);
+    write_decimal(n, sink);
+}
+
+void write_decimal(const int fd, const Bignum& n) {
+    FileDescriptorDecimalSink sink(fd);
+    write_decimal(n, sink);
+}
+
+std::ostream& operator<<(std::ostream& out, const Bignum& n) {
+    write_decimal(out, n);
     return out;
 }
@@ -4,6 +4,7 @@
 #include <tr1/cstdint>
 #include <deque>
 #include <iostream>
+#include <tr1/functional>
 
 class Bignum {
     public:
@@ -17,22 +18,72 @@ class Bignum {
 
         const Bignum& operator+=(const Bignum&);
         const Bignum& operator-=(const Bignum&);
+        const Bignum& operator*=(const Bignum&);
+        const Bignum& operator/=(const Bignum&);
+        const Bignum& operator%=(const Bignum&);
+        const Bignum& operator+=(int);
+        const Bignum& operator+=(unsigned int);
+        const Bignum& operator+=(long);
+        const Bignum& operator+=(unsigned long);
+        const Bignum& operator+=(long long);
+        const Bignum& operator+=(unsigned long long);
+        const Bignum& operator-=(int);
+        const Bignum& operator-=(unsigned int);
+        const Bignum& operator-=(long);
+        const Bignum& operator-=(unsigned long);
+        const Bignum& operator-=(long long);
+        const Bignum& operator-=(unsigned long long);
+        const Bignum& operator*=(int);
+        const Bignum& operator*=(unsigned int);
+        const Bignum& operator*=(long);
+        const Bignum& operator*=(unsigned long);
+        const Bignum& operator*=(long long);
+        const Bignum& operator*=(unsigned long long);
+        const Bignum& operator/=(int);
+        const Bignum& operator/=(unsigned int);
+        const Bignum& operator/=(long);
+        const Bignum& operator/=(unsigned long);
+        const Bignum& operator/=(long long);
+        const Bignum& operator/=(unsigned long long);
         const Bignum& operator>>=(unsigned int);
         const Bignum& operator<<=(unsigned int);
+        const Bignum& operator&=(const Bignum&);
+        const Bignum& operator|=(const Bignum&);
+        const Bignum& operator^=(const Bignum&);
         Bignum operator-() const;
+        Bignum operator~() const;
         Bignum abs() const;
 
+        int compare(const Bignum&) const;
+        int compare(int) const;
+        int compare(unsigned int) const;
+        int compare(long) const;
+        int compare(unsigned long) const;
+        int compare(long long) const;
+        int compare(unsigned long long) const;
         bool equal(const Bignum&) const;
         bool less(const Bignum&) const;
+        uint64_t hash() const;
         int signum() const;
-
-        friend std::ostream& operator<<(std::ostream&, const Bignum&);
+        uint64_t bit_length() const;
+        uint32_t remainder(uint32_t) const;
+        bool test_bit(uint64_t) const;
+        void set_bit(uint64_t);
+        void clear_bit(uint64_t);
+        const std::deque<uint32_t>& digits() const;
 
     private:
         std::deque<uint32_t> store;
         int sign;
+        // The index of the lowest non-zero digit, or store.size() for zero.
+        std::deque<uint32_t>::size_type lowest_digit;
 
-        void reconcile_sign_of_zero();
+        void reconcile();
+        void reconcile_above(std::deque<uint32_t>::size_type);
+        void add_native(uint64_t, int);
+        void multiply_native(uint64_t, int);
+        void divide_native(uint64_t, int);
+        int compare_native(uint64_t, int) const;
 };
 
 bool operator==(const Bignum&, const Bignum&);
@@ -43,11 +94,119 @@ bool operator>(const Bignum&, const Bignum&);
 bool operator>=(const Bignum&, const Bignum&);
 Bignum operator+(const Bignum&, const Bignum&);
 Bignum operator-(const Bignum&, const Bignum&);
+Bignum operator*(const Bignum&, const Bignum&);
+Bignum operator/(const Bignum&, const Bignum&);
+Bignum operator%(const Bignum&, const Bignum&);
+bool operator==(const Bignum&, int);
+bool operator==(const Bignum&, unsigned int);
+bool operator==(const Bignum&, long);
+bool operator==(const Bignum&, unsigned long);
+bool operator==(const Bignum&, long long);
+bool operator==(const Bignum&, unsigned long long);
+bool operator!=(const Bignum&, int);
+bool operator!=(const Bignum&, unsigned int);
+bool operator!=(const Bignum&, long);
+bool operator!=(const Bignum&, unsigned long);
+bool operator!=(const Bignum&, long long);
+bool operator!=(const Bignum&, unsigned long long);
+bool operator<(const Bignum&, int);
+bool operator<(const Bignum&, unsigned int);
+bool operator<(const Bignum&, long);
+bool operator<(const Bignum&, unsigned long);
+bool operator<(const Bignum&, long long);
+bool operator<(const Bignum&, unsigned long long);
+bool operator<=(const Bignum&, int);
+bool operator<=(const Bignum&, unsigned int);
+bool operator<=(const Bignum&, long);
+bool operator<=(const Bignum&, unsigned long);
+bool operator<=(const Bignum&, long long);
+bool operator<=(const Bignum&, unsigned long long);
+bool operator>(const Bignum&, int);
+bool operator>(const Bignum&, unsigned int);
+bool operator>(const Bignum&, long);
+bool operator>(const Bignum&, unsigned long);
+bool operator>(const Bignum&, long long);
+bool operator>(const Bignum&, unsigned long long);
+bool operator>=(const Bignum&, int);
+bool operator>=(const Bignum&, unsigned int);
+bool operator>=(const Bignum&, long);
+bool operator>=(const Bignum&, unsigned long);
+bool operator>=(const Bignum&, long long);
+bool operator>=(const Bignum&, unsigned long long);
+Bignum operator+(const Bignum&, int);
+Bignum operator+(const Bignum&, unsigned int);
+Bignum operator+(const Bignum&, long);
+Bignum operator+(const Bignum&, unsigned long);
+Bignum operator+(const Bignum&, long long);
+Bignum operator+(const Bignum&, unsigned long long);
+Bignum operator-(const Bignum&, int);
+Bignum operator-(const Bignum&, unsigned int);
+Bignum operator-(const Bignum&, long);
+Bignum operator-(const Bignum&, unsigned long);
+Bignum operator-(const Bignum&, long long);
+Bignum operator-(const Bignum&, unsigned long long);
+Bignum operator*(const Bignum&, int);
+Bignum operator*(const Bignum&, unsigned int);
+Bignum operator*(const Bignum&, long);
+Bignum operator*(const Bignum&, unsigned long);
+Bignum operator*(const Bignum&, long long);
+Bignum operator*(const Bignum&, unsigned long long);
+Bignum operator/(const Bignum&, int);
+Bignum operator/(const Bignum&, unsigned int);
+Bignum operator/(const Bignum&, long);
+Bignum operator/(const Bignum&, unsigned long);
+Bignum operator/(const Bignum&, long long);
+Bignum operator/(const Bignum&, unsigned long long);
 Bignum& operator++(Bignum&);
 Bignum operator++(Bignum&, int);
 Bignum& operator--(Bignum&);
 Bignum operator--(Bignum&, int);
 Bignum operator>>(const Bignum& n, unsigned int);
 Bignum operator<<(const Bignum& n, unsigned int);
+Bignum operator&(const Bignum&, const Bignum&);
+Bignum operator|(const Bignum&, const Bignum&);
+Bignum operator^(const Bignum&, const Bignum&);
+Bignum integer_square_root(const Bignum&);
+Bignum power_of(const Bignum&, uint64_t);
+uint32_t word_power_mod(uint64_t, uint64_t, uint32_t);
+std::ostream& operator<<(std::ostream&, const Bignum&);
+void write_decimal(std::ostream&, const Bignum&);
+void write_decimal(int, const Bignum&);
+
+// Operand sizes, in digits, at which Bignum switches to the next tier of
+// an algorithm.  They are read on first use from the file named by
+// $BIGNUM_THRESHOLDS, or else bignum_thresholds.conf in the working
+// directory, as written by tune_thresholds; settings the file lacks keep
+// their defaults, and a file with any bad setting is ignored.
+// set_bignum_thresholds() is for tuning and tests, and must not race with
+// arithmetic on other threads.
+struct BignumThresholds {
+    static const std::size_t MINIMUM_KARATSUBA_DIGITS;
+
+    BignumThresholds();
+
+    std::size_t block_add_digits;
+    std::size_t bulk_shift_digits;
+    std::size_t karatsuba_digits;
+};
+
+const BignumThresholds& bignum_thresholds();
+void set_bignum_thresholds(const BignumThresholds&);
+bool read_bignum_thresholds(std::istream&, BignumThresholds&);
+void write_bignum_thresholds(std::ostream&, const BignumThresholds&);
+
+namespace std {
+    namespace tr1 {
+        template <>
+        struct hash<Bignum> {
+            typedef Bignum argument_type;
+            typedef std::size_t result_type;
+
+            std::size_t operator()(const Bignum& n) const {
+                return n.hash();
+            }
+        };
+    }
+}
 
 #endif  // PHOLSER_BIGNUM_H
@@ -0,0 +1,140 @@
+#include "BignumAccumulator.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <deque>
+
+const uint64_t BignumAccumulator::TERMS_BEFORE_CARRY = UINT32_MAX;
+
+// Leaves every lane below 2^32, moving the excess into the next lane up.
+void carry_lanes(std::vector<uint64_t>& lanes) {
+    for (std::vector<uint64_t>::size_type i = 0; i < lanes.size(); ++i) {
+        uint64_t excess = lanes[i] >> Bignum::BITS_IN_DIGIT;
+        if (excess == 0)
+            continue;
+
+        if (i + 1 == lanes.size())
+            lanes.push_back(0);
+        lanes[i + 1] += excess;
+        lanes[i] &= UINT32_MAX;
+    }
+}
+
+Bignum lanes_to_bignum(std::vector<uint64_t> lanes) {
+    carry_lanes(lanes);
+
+    std::deque<uint32_t> digits(lanes.begin(), lanes.end());
+    while (digits.size() > 1 && digits.back() == 0U)
+        digits.pop_back();
+    if (digits.empty() || (digits.size() == 1 && digits[0] == 0U))
+        return Bignum(0);
+
+    return Bignum(digits, 1);
+}
+
+BignumAccumulator::BignumAccumulator() : positive(), negative(), terms(0) {
+}
+
+const BignumAccumulator& BignumAccumulator::operator+=(const Bignum& n) {
+    accumulate(n, n.signum());
+    return *this;
+}
+
+const BignumAccumulator& BignumAccumulator::operator-=(const Bignum& n) {
+    accumulate(n, -n.signum());
+    return *this;
+}
+
+void BignumAccumulator::accumulate(const Bignum& n, const int sign) {
+    if (sign == 0)
+        return;
+
+    if (terms == TERMS_BEFORE_CARRY)
+        carry();
+
+    std::vector<uint64_t>& lanes = sign > 0 ? positive : negative;
+    const std::deque<uint32_t>& digits = n.digits();
+    if (lanes.size() < digits.size())
+        lanes.resize(digits.size(), 0);
+
+    std::vector<uint64_t>::iterator lane = lanes.begin();
+    for (std::deque<uint32_t>::const_iterator i = digits.begin(); i != digits.end(); ++i, ++lane)
+        *lane += *i;
+
+    ++terms;
+}
+
+void BignumAccumulator::carry() {
+    carry_lanes(positive);
+    carry_lanes(negative);
+    terms = 0;
+}
+
+void BignumAccumulator::merge(const BignumAccumulator& other) {
+    if (this == &other) {
+        BignumAccumulator copy(other);
+        merge(copy);
+        return;
+    }
+
+    // With both sides carried, the merged lanes hold no more than a
+    // carried accumulator plus one more term would.
+    carry();
+    std::vector<uint64_t> other_positive(other.positive);
+    std::vector<uint64_t> other_negative(other.negative);
+    carry_lanes(other_positive);
+    carry_lanes(other_negative);
+
+    positive.resize(std::max(positive.size(), other_positive.size()), 0);
+    for (std::vector<uint64_t>::size_type i = 0; i < other_positive.size(); ++i)
+        positive[i] += other_positive[i];
+
+    negative.resize(std::max(negative.size(), other_negative.size()), 0);
+    for (std::vector<uint64_t>::size_type i = 0; i < other_negative.size(); ++i)
+        negative[i] += other_negative[i];
+
+    terms = 1;
+}
+
+void BignumAccumulator::clear() {
+    positive.clear();
+    negative.clear();
+    terms = 0;
+}
+
+Bignum BignumAccumulator::total() const {
+    return lanes_to_bignum(positive) - lanes_to_bignum(negative);
+}
+
+class PartialSumTask : public ParallelTask {
+    public:
+        PartialSumTask(const std::vector<Bignum>& values, std::vector<BignumAccumulator>& partials)
+            : values(values), partials(partials) {
+        }
+
+        void run(std::size_t begin, std::size_t end) {
+            for (std::size_t slice = begin; slice < end; ++slice) {
+                std::size_t first = values.size() * slice / partials.size();
+                std::size_t last = values.size() * (slice + 1) / partials.size();
+                for (std::size_t i = first; i < last; ++i)
+                    partials[slice] += values[i];
+            }
+        }
+
+    private:
+        const std::vector<Bignum>& values;
+        std::vector<BignumAccumulator>& partials;
+};
+
+// Each thread fills a private accumulator over its own slice; the
+// partials are merged once every thread is done.
+Bignum parallel_sum(const std::vector<Bignum>& values, const unsigned int threads) {
+    std::vector<BignumAccumulator> partials(std::max(threads, 1U));
+    PartialSumTask task(values, partials);
+    parallel_for(task, partials.size(), partials.size());
+
+    BignumAccumulator sum;
+    for (std::vector<BignumAccumulator>::size_type i = 0; i < partials.size(); ++i)
+        sum.merge(partials[i]);
+
+    return sum.total();
+}
@@ -0,0 +1,36 @@
+#ifndef PHOLSER_BIGNUM_ACCUMULATOR_H
+#define PHOLSER_BIGNUM_ACCUMULATOR_H
+
+#include "Bignum.h"
+#include <tr1/cstdint>
+#include <vector>
+
+// Sums many Bignums without resolving carries on every step.  Each digit
+// position gets a 64-bit lane, separately for positive and negative
+// terms, so up to 2^32 - 1 terms can pile up before any carrying is
+// needed; the carries are only resolved when the total is read.
+class BignumAccumulator {
+    public:
+        static const uint64_t TERMS_BEFORE_CARRY;
+
+        BignumAccumulator();
+
+        const BignumAccumulator& operator+=(const Bignum&);
+        const BignumAccumulator& operator-=(const Bignum&);
+        void merge(const BignumAccumulator&);
+        void clear();
+
+        Bignum total() const;
+
+    private:
+        std::vector<uint64_t> positive;
+        std::vector<uint64_t> negative;
+        uint64_t terms;
+
+        void accumulate(const Bignum&, int);
+        void carry();
+};
+
+Bignum parallel_sum(const std::vector<Bignum>&, unsigned int);
+
+#endif  // PHOLSER_BIGNUM_ACCUMULATOR_H
@@ -0,0 +1,86 @@
+#include "BignumAccumulator.h"
+#include "RandomBignum.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+std::vector<Bignum> mixed_terms(int count) {
+    std::vector<Bignum> terms;
+    RandomBignum random(0x9E3779B97F4A7C15ULL);
+    for (int i = 0; i < count; ++i) {
+        Bignum term = (random.bits(63) << (unsigned int) (random.next() % 200)) + i;
+        terms.push_back(i % 3 == 0 ? -term : term);
+    }
+
+    return terms;
+}
+
+Bignum sequential_sum(const std::vector<Bignum>& terms) {
+    Bignum sum(0);
+    for (std::vector<Bignum>::size_type i = 0; i < terms.size(); ++i)
+        sum += terms[i];
+
+    return sum;
+}
+
+TEST(BignumAccumulatorTest, EmptyTotalIsZero) {
+    BignumAccumulator accumulator;
+
+    ASSERT_EQ(Bignum(0), accumulator.total());
+}
+
+TEST(BignumAccumulatorTest, SignedAddsAndSubtracts) {
+    BignumAccumulator accumulator;
+    accumulator += Bignum(10);
+    accumulator += Bignum(-4);
+    accumulator -= Bignum(-1);
+    accumulator -= Bignum(20);
+
+    ASSERT_EQ(Bignum(-13), accumulator.total());
+}
+
+TEST(BignumAccumulatorTest, CarriesAreResolvedOnRead) {
+    BignumAccumulator accumulator;
+    Bignum all_ones = (Bignum(1) << 128) - 1;
+    for (int i = 0; i < 100000; ++i)
+        accumulator += all_ones;
+
+    ASSERT_EQ(all_ones * 100000, accumulator.total());
+}
+
+TEST(BignumAccumulatorTest, ManyMixedTerms) {
+    std::vector<Bignum> terms = mixed_terms(5000);
+    BignumAccumulator accumulator;
+    for (std::vector<Bignum>::size_type i = 0; i < terms.size(); ++i)
+        accumulator += terms[i];
+
+    ASSERT_EQ(sequential_sum(terms), accumulator.total());
+}
+
+TEST(BignumAccumulatorTest, MergingAccumulators) {
+    BignumAccumulator first;
+    BignumAccumulator second;
+    first += Bignum(1) << 100;
+    second -= Bignum(1) << 64;
+    second += Bignum(5);
+    first.merge(second);
+    first.merge(first);
+
+    ASSERT_EQ(((Bignum(1) << 100) - (Bignum(1) << 64) + 5) * 2, first.total());
+}
+
+TEST(BignumAccumulatorTest, ClearingStartsOver) {
+    BignumAccumulator accumulator;
+    accumulator += Bignum(99);
+    accumulator.clear();
+    accumulator += Bignum(1);
+
+    ASSERT_EQ(Bignum(1), accumulator.total());
+}
+
+TEST(BignumAccumulatorTest, ParallelSumMatchesSequentialSum) {
+    std::vector<Bignum> terms = mixed_terms(20000);
+
+    ASSERT_EQ(sequential_sum(terms), parallel_sum(terms, 8));
+    ASSERT_EQ(sequential_sum(terms), parallel_sum(terms, 1));
+    ASSERT_EQ(Bignum(0), parallel_sum(std::vector<Bignum>(), 4));
+}
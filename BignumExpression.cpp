@@ -0,0 +1,687 @@
+#include "BignumExpression.h"
+#include <cfloat>
+#include <cmath>
+#include <stdexcept>
+
+const uint64_t BignumExpression::MATERIALIZE_LIMIT = 1ULL << 20;
+const uint64_t BignumExpression::MAX_TOWER_HEIGHT = 1ULL << 12;
+
+const long double LN_2 = 0.693147180559945309417232121458176568L;
+const long double LOG10_2 = 0.301029995663981195213738894724493027L;
+const long double TWO_TO_64 = 18446744073709551616.0L;
+const long double LEVEL_FLOOR = 64.0L;
+const long double EXPONENT_CEILING = 16000.0L;
+const long double ROUNDING = 4 * LDBL_EPSILON;
+
+// A positive value v estimated as E^height(x), where E(y) = 2^y, with
+// |x - true x| <= error.  At height 0, x is the value itself and lies
+// below 2^64; above that, x lies in [64, 2^64), so a greater height
+// always means a greater value.
+struct Magnitude {
+    int height;
+    long double x;
+    long double error;
+};
+
+Magnitude make_magnitude(const int height, const long double x, const long double error) {
+    Magnitude m;
+    m.height = height;
+    m.x = x;
+    m.error = error;
+    return m;
+}
+
+long double log_2(const long double x) {
+    return std::log(x) / LN_2;
+}
+
+Magnitude exponentiate_one_level(const Magnitude& m) {
+    long double x = std::pow(2.0L, m.x);
+    return make_magnitude(m.height - 1, x, x * (std::pow(2.0L, m.error) - 1) + ROUNDING * x);
+}
+
+Magnitude normalize(Magnitude m) {
+    while (m.height > 0 && m.x < LEVEL_FLOOR)
+        m = exponentiate_one_level(m);
+
+    while (m.x >= TWO_TO_64) {
+        long double x = log_2(m.x);
+        m = make_magnitude(m.height + 1, x, m.error / (m.x * LN_2) + ROUNDING * x);
+    }
+
+    return m;
+}
+
+Magnitude lower(const Magnitude& m) {
+    if (m.height > 0)
+        return make_magnitude(m.height - 1, m.x, m.error);
+
+    long double x = log_2(m.x);
+    return make_magnitude(0, x, m.error / (m.x * LN_2) + ROUNDING * x);
+}
+
+Magnitude raise(const Magnitude& m) {
+    return normalize(make_magnitude(m.height + 1, m.x, m.error));
+}
+
+bool magnitude_less(const Magnitude& first, const Magnitude& second) {
+    return first.height != second.height ? first.height < second.height : first.x < second.x;
+}
+
+Magnitude add_magnitudes(const Magnitude& first, const Magnitude& second) {
+    if (first.height == 0 && second.height == 0) {
+        long double x = first.x + second.x;
+        return normalize(make_magnitude(0, x, first.error + second.error + ROUNDING * x));
+    }
+
+    const Magnitude& larger = magnitude_less(first, second) ? second : first;
+    const Magnitude& smaller = magnitude_less(first, second) ? first : second;
+
+    // Doubling a value at height 2 or more moves its x by less than 2^-63.
+    if (larger.height >= 2)
+        return make_magnitude(larger.height, larger.x, larger.error + ROUNDING * larger.x + 1 / TWO_TO_64);
+
+    Magnitude log_larger = lower(larger);
+    Magnitude log_smaller = lower(smaller);
+    long double x = log_larger.x + log_2(1 + std::pow(2.0L, log_smaller.x - log_larger.x));
+    return raise(make_magnitude(0, x, log_larger.error + log_smaller.error + ROUNDING * x));
+}
+
+Magnitude multiply_magnitudes(const Magnitude& first, const Magnitude& second) {
+    if (first.height == 0 && second.height == 0) {
+        long double x = first.x * second.x;
+        long double error = first.x * second.error + second.x * first.error + first.error * second.error;
+        return normalize(make_magnitude(0, x, error + ROUNDING * x));
+    }
+
+    return raise(add_magnitudes(lower(first), lower(second)));
+}
+
+Magnitude offset_magnitude(const Magnitude& m, const int64_t delta) {
+    if (m.height == 0) {
+        long double x = m.x + delta;
+        return normalize(make_magnitude(0, x, m.error + ROUNDING * x));
+    }
+
+    if (m.height == 1 && m.x < EXPONENT_CEILING) {
+        long double x = m.x + log_2(1 + delta * std::pow(2.0L, -m.x));
+        return make_magnitude(1, x, m.error + ROUNDING * x);
+    }
+
+    return make_magnitude(m.height, m.x, m.error + ROUNDING * m.x);
+}
+
+Magnitude literal_magnitude(const Bignum& value) {
+    const std::deque<uint32_t>& digits = value.digits();
+
+    if (value.bit_length() <= 64) {
+        long double x = 0;
+        for (std::deque<uint32_t>::const_reverse_iterator i = digits.rbegin(); i != digits.rend(); ++i)
+            x = x * Bignum::BASE + *i;
+        return make_magnitude(0, x, 0);
+    }
+
+    std::deque<uint32_t>::size_type n = digits.size();
+    long double top = ((long double) digits[n - 1] * Bignum::BASE + digits[n - 2]) * Bignum::BASE + digits[n - 3];
+    long double x = log_2(top) + (n - 3) * (long double) Bignum::BITS_IN_DIGIT;
+    return normalize(make_magnitude(1, x, 4 / TWO_TO_64 + ROUNDING * x));
+}
+
+int compare_magnitudes(Magnitude first, Magnitude second, bool& decided) {
+    decided = true;
+
+    while (first.height != second.height) {
+        Magnitude& higher = first.height > second.height ? first : second;
+        const Magnitude& lesser = first.height > second.height ? second : first;
+        if (higher.height - lesser.height >= 2 || higher.x - higher.error >= EXPONENT_CEILING)
+            return first.height > second.height ? 1 : -1;
+        higher = exponentiate_one_level(higher);
+    }
+
+    if (first.x + first.error < second.x - second.error)
+        return -1;
+    if (second.x + second.error < first.x - first.error)
+        return 1;
+
+    decided = false;
+    return 0;
+}
+
+bool to_uint64(const Bignum& value, uint64_t& result) {
+    if (value.bit_length() > 64)
+        return false;
+
+    const std::deque<uint32_t>& digits = value.digits();
+    result = digits[0];
+    if (digits.size() > 1)
+        result |= (uint64_t) digits[1] << Bignum::BITS_IN_DIGIT;
+
+    return true;
+}
+
+uint32_t totient(uint32_t n) {
+    uint32_t result = n;
+
+    for (uint32_t p = 2; (uint64_t) p * p <= n; ++p) {
+        if (n % p == 0) {
+            while (n % p == 0)
+                n /= p;
+            result -= result / p;
+        }
+    }
+
+    if (n > 1)
+        result -= result / n;
+
+    return result;
+}
+
+bool word_power_equals(const uint64_t root, const unsigned int exponent, const uint64_t value) {
+    uint64_t power = 1;
+    for (unsigned int i = 0; i < exponent; ++i) {
+        if (power > value / root)
+            return false;
+        power *= root;
+    }
+
+    return power == value;
+}
+
+// The largest k for which value is a perfect k-th power, along with its
+// k-th root.
+unsigned int smallest_root(const uint64_t value, uint64_t& root) {
+    for (unsigned int exponent = 63; exponent > 1; --exponent) {
+        uint64_t estimate = (uint64_t) (std::pow((long double) value, 1.0L / exponent) + 0.5L);
+        for (uint64_t candidate = estimate > 2 ? estimate - 1 : 2; candidate <= estimate + 1; ++candidate) {
+            if (word_power_equals(candidate, exponent, value)) {
+                root = candidate;
+                return exponent;
+            }
+        }
+    }
+
+    root = value;
+    return 1;
+}
+
+uint64_t trailing_zero_bits(const Bignum& value) {
+    const std::deque<uint32_t>& digits = value.digits();
+
+    uint64_t zeros = 0;
+    std::deque<uint32_t>::size_type i = 0;
+    for (; digits[i] == 0; ++i)
+        zeros += Bignum::BITS_IN_DIGIT;
+    for (uint32_t digit = digits[i]; (digit & 1) == 0; digit >>= 1)
+        ++zeros;
+
+    return zeros;
+}
+
+uint64_t decimal_digit_count(const Bignum& value) {
+    if (value.signum() == 0)
+        return 1;
+
+    uint64_t at_least = (uint64_t) std::floor((value.bit_length() - 1) * LOG10_2) + 1;
+    return value.abs() < power_of(Bignum(10), at_least) ? at_least : at_least + 1;
+}
+
+struct BignumExpression::Node {
+    enum Kind { LITERAL, POWER, OFFSET };
+
+    Kind kind;
+    Bignum value;
+    std::tr1::shared_ptr<Node> first;
+    std::tr1::shared_ptr<Node> second;
+    int64_t delta;
+
+    mutable std::tr1::shared_ptr<Bignum> materialized;
+    mutable std::tr1::shared_ptr<Magnitude> estimate;
+
+    Node(Kind kind, const Bignum& value, const std::tr1::shared_ptr<Node>& first,
+        const std::tr1::shared_ptr<Node>& second, int64_t delta)
+        : kind(kind), value(value), first(first), second(second), delta(delta) {
+    }
+
+    const Magnitude& magnitude() const {
+        if (!estimate)
+            estimate.reset(new Magnitude(compute_magnitude()));
+
+        return *estimate;
+    }
+
+    Magnitude compute_magnitude() const {
+        switch (kind) {
+            case LITERAL:
+                return literal_magnitude(value);
+            case OFFSET:
+                return offset_magnitude(first->magnitude(), delta);
+            case POWER:
+                return raise(multiply_magnitudes(second->magnitude(), lower(first->magnitude())));
+        }
+
+        throw std::logic_error("unknown expression kind");
+    }
+
+    bool small_value(uint64_t& result) const {
+        if (kind == LITERAL)
+            return to_uint64(value, result);
+
+        return magnitude().height == 0 && to_uint64(materialize(), result);
+    }
+
+    bool power_of_two(uint64_t& exponent) const {
+        uint64_t base_exponent;
+        uint64_t power;
+
+        switch (kind) {
+            case LITERAL:
+                exponent = value.bit_length() - 1;
+                return value.signum() != 0 && value == Bignum(1) << exponent;
+            case POWER:
+                if (!first->power_of_two(base_exponent) || !second->small_value(power))
+                    return false;
+                exponent = base_exponent * power;
+                return base_exponent == 0 || exponent / base_exponent == power;
+            case OFFSET:
+                return false;
+        }
+
+        return false;
+    }
+
+    bool power_of_ten(uint64_t& exponent) const {
+        uint64_t base_exponent;
+        uint64_t power;
+
+        switch (kind) {
+            case LITERAL:
+                // 10^k has exactly k trailing zero bits, which pins down the
+                // only candidate; its bit length rules out most other values.
+                if (value.signum() == 0)
+                    return false;
+                exponent = trailing_zero_bits(value);
+                if (std::fabs(value.bit_length() - 1 - exponent / LOG10_2) > 1)
+                    return false;
+                return value == power_of(Bignum(10), exponent);
+            case POWER:
+                if (!first->power_of_ten(base_exponent) || !second->small_value(power))
+                    return false;
+                exponent = base_exponent * power;
+                return base_exponent == 0 || exponent / base_exponent == power;
+            case OFFSET:
+                return false;
+        }
+
+        return false;
+    }
+
+    // Writes a value of at least 2 as root^exponent, with root as small as
+    // this can find: the smallest root of a literal that fits in 64 bits,
+    // 2 for larger powers of two, and otherwise the literal itself.
+    bool root_power(Bignum& root, Bignum& exponent) const {
+        uint64_t small;
+        uint64_t smallest;
+
+        switch (kind) {
+            case LITERAL:
+                if (value < 2)
+                    return false;
+                if (to_uint64(value, small)) {
+                    exponent = Bignum((int64_t) smallest_root(small, smallest));
+                    root = Bignum((int64_t) smallest);
+                } else if (value == Bignum(1) << (value.bit_length() - 1)) {
+                    exponent = Bignum((int64_t) value.bit_length() - 1);
+                    root = Bignum(2);
+                } else {
+                    exponent = Bignum(1);
+                    root = value;
+                }
+                return true;
+            case POWER:
+                if (!second->materializable() || !first->root_power(root, exponent))
+                    return false;
+                exponent *= second->materialize();
+                return true;
+            case OFFSET:
+                return false;
+        }
+
+        return false;
+    }
+
+    bool materializable() const {
+        const Magnitude& m = magnitude();
+        return m.height == 0 || (m.height == 1 && m.x + m.error < BignumExpression::MATERIALIZE_LIMIT);
+    }
+
+    const Bignum& materialize() const {
+        if (kind == LITERAL)
+            return value;
+        if (materialized)
+            return *materialized;
+        if (!materializable())
+            throw std::length_error("expression is too large to materialize");
+
+        uint64_t exponent;
+
+        switch (kind) {
+            case OFFSET:
+                materialized.reset(new Bignum(first->materialize() + Bignum(delta)));
+                break;
+            case POWER:
+                if (!second->small_value(exponent))
+                    throw std::length_error("exponent is too large to materialize");
+                materialized.reset(new Bignum(power_of(first->materialize(), exponent)));
+                break;
+            default:
+                break;
+        }
+
+        return *materialized;
+    }
+
+    uint32_t residue(const uint32_t modulus) const {
+        if (modulus == 1)
+            return 0;
+
+        uint64_t exponent;
+        uint32_t phi;
+
+        switch (kind) {
+            case LITERAL:
+                return value.remainder(modulus);
+            case OFFSET:
+                return (first->residue(modulus) + modulus + delta % (int64_t) modulus) % modulus;
+            case POWER:
+                if (second->small_value(exponent) && exponent < 64)
+                    return word_power_mod(first->residue(modulus), exponent, modulus);
+
+                // Euler's theorem, generalized to bases sharing factors with
+                // the modulus; valid because the exponent exceeds log2(modulus).
+                phi = totient(modulus);
+                return word_power_mod(first->residue(modulus), (uint64_t) phi + second->residue(phi), modulus);
+        }
+
+        throw std::logic_error("unknown expression kind");
+    }
+
+    bool same_as(const Node& other) const {
+        if (this == &other)
+            return true;
+        if (kind != other.kind)
+            return false;
+
+        switch (kind) {
+            case LITERAL:
+                return value == other.value;
+            case POWER:
+                return first->same_as(*other.first) && second->same_as(*other.second);
+            case OFFSET:
+                return delta == other.delta && first->same_as(*other.first);
+        }
+
+        return false;
+    }
+
+    const Node& without_offsets(int64_t& total) const {
+        total = 0;
+        const Node* core = this;
+        for (; core->kind == OFFSET; core = core->first.get())
+            total += core->delta;
+
+        return *core;
+    }
+};
+
+BignumExpression::BignumExpression(const Bignum& value)
+    : node(new Node(Node::LITERAL, value, std::tr1::shared_ptr<Node>(), std::tr1::shared_ptr<Node>(), 0)) {
+    if (value.signum() < 0)
+        throw std::invalid_argument("expressions must be non-negative");
+}
+
+BignumExpression::BignumExpression(const std::tr1::shared_ptr<Node>& node)
+    : node(node) {
+}
+
+BignumExpression BignumExpression::power(const BignumExpression& base, const BignumExpression& exponent) {
+    // x^0 = 1, 0^y = 0 and 1^y = 1 whatever the size of y, so these never
+    // become nodes that would have to materialize y.
+    uint64_t small;
+    if (exponent.node->small_value(small) && small == 0)
+        return BignumExpression(Bignum(1));
+    if (base.node->small_value(small) && small < 2)
+        return base;
+
+    return BignumExpression(std::tr1::shared_ptr<Node>(new Node(Node::POWER, Bignum(0), base.node, exponent.node, 0)));
+}
+
+BignumExpression BignumExpression::mersenne(const uint64_t exponent) {
+    return power(Bignum(2), Bignum((int64_t) exponent)).offset(-1);
+}
+
+BignumExpression BignumExpression::tower(const std::vector<Bignum>& levels) {
+    if (levels.empty())
+        throw std::invalid_argument("a tower needs at least one level");
+    if (levels.size() > MAX_TOWER_HEIGHT)
+        throw std::length_error("tower is too tall");
+
+    BignumExpression result(levels.back());
+    for (std::vector<Bignum>::size_type i = levels.size() - 1; i > 0; --i)
+        result = power(levels[i - 1], result);
+
+    return result;
+}
+
+BignumExpression BignumExpression::up_arrow(const uint64_t base, const unsigned int arrows, const uint64_t count) {
+    if (arrows == 0)
+        throw std::invalid_argument("up-arrow notation needs at least one arrow");
+
+    if (arrows == 1)
+        return power(Bignum((int64_t) base), Bignum((int64_t) count));
+    if (count == 0 || base == 1)
+        return BignumExpression(Bignum(1));
+    if (arrows == 2) {
+        if (count > MAX_TOWER_HEIGHT)
+            throw std::length_error("tower is too tall");
+        return tower(std::vector<Bignum>(count, Bignum((int64_t) base)));
+    }
+
+    // a ^...^ b, with n arrows, is a ^...^ (a ^...^ (b - 1)) with n - 1 arrows.
+    uint64_t inner;
+    if (!up_arrow(base, arrows, count - 1).node->small_value(inner))
+        throw std::length_error("up-arrow expansion is too deep");
+
+    return up_arrow(base, arrows - 1, inner);
+}
+
+BignumExpression BignumExpression::offset(const int64_t delta) const {
+    if (delta == 0)
+        return *this;
+    if (delta < 0 && compare(Bignum(delta).abs()) < 0)
+        throw std::invalid_argument("expressions must be non-negative");
+
+    return BignumExpression(std::tr1::shared_ptr<Node>(new Node(Node::OFFSET, Bignum(0), node, std::tr1::shared_ptr<Node>(), delta)));
+}
+
+int BignumExpression::compare(const BignumExpression& other) const {
+    if (node->same_as(*other.node))
+        return 0;
+
+    int64_t this_offset;
+    int64_t other_offset;
+    if (node->without_offsets(this_offset).same_as(other.node->without_offsets(other_offset)))
+        return this_offset < other_offset ? -1 : (this_offset > other_offset ? 1 : 0);
+
+    bool decided;
+    int order = compare_magnitudes(node->magnitude(), other.node->magnitude(), decided);
+    if (decided)
+        return order;
+
+    // root^a + c against root^b + d: equal powers leave the offsets to
+    // decide, and otherwise root^max(a, b) - root^min(a, b) >= 2^64 outweighs
+    // any pair of offsets once min(a, b) >= 64.
+    Bignum this_root(0);
+    Bignum other_root(0);
+    Bignum this_exponent(0);
+    Bignum other_exponent(0);
+    if (node->without_offsets(this_offset).root_power(this_root, this_exponent)
+        && other.node->without_offsets(other_offset).root_power(other_root, other_exponent)
+        && this_root == other_root) {
+        if (this_exponent == other_exponent)
+            return this_offset < other_offset ? -1 : (this_offset > other_offset ? 1 : 0);
+        if (this_exponent >= 64 && other_exponent >= 64)
+            return this_exponent.compare(other_exponent);
+    }
+
+    if (!node->materializable() || !other.node->materializable())
+        throw std::domain_error("comparison is beyond the precision of the magnitude estimates");
+
+    return node->materialize().compare(other.node->materialize());
+}
+
+uint64_t BignumExpression::bit_length() const {
+    int64_t delta;
+    uint64_t exponent;
+    if (node->without_offsets(delta).power_of_two(exponent) && exponent >= 64) {
+        // |delta| <= 2^63 leaves the top bit where it was, or one lower.
+        return delta >= 0 ? exponent + 1 : exponent;
+    }
+
+    const Magnitude& m = node->magnitude();
+    if (m.height >= 2)
+        throw std::overflow_error("bit length does not fit in 64 bits");
+
+    if (m.height == 1 && std::floor(m.x - m.error) == std::floor(m.x + m.error))
+        return (uint64_t) std::floor(m.x) + 1;
+
+    if (!node->materializable())
+        throw std::domain_error("bit length is beyond the precision of the magnitude estimates");
+
+    return node->materialize().bit_length();
+}
+
+uint64_t BignumExpression::digit_count() const {
+    int64_t delta;
+    uint64_t exponent;
+    if (node->without_offsets(delta).power_of_ten(exponent) && exponent >= 19) {
+        // |delta| <= 2^63 < 9 * 10^18 leaves the leading digit where it
+        // was, or one lower.
+        return delta >= 0 ? exponent + 1 : exponent;
+    }
+
+    const Magnitude& m = node->magnitude();
+    if (m.height >= 2)
+        throw std::overflow_error("digit count does not fit in 64 bits");
+
+    if (m.height == 1) {
+        long double log10 = m.x * LOG10_2;
+        long double error = (m.error + ROUNDING * m.x) * LOG10_2;
+        if (std::floor(log10 - error) == std::floor(log10 + error))
+            return (uint64_t) std::floor(log10) + 1;
+    }
+
+    if (!node->materializable())
+        throw std::domain_error("digit count is beyond the precision of the magnitude estimates");
+
+    return decimal_digit_count(node->materialize());
+}
+
+uint64_t BignumExpression::leading_digits(const unsigned int count) const {
+    if (count == 0 || count > 18)
+        throw std::invalid_argument("can only extract between 1 and 18 leading digits");
+
+    int64_t delta;
+    uint64_t exponent;
+    if (node->without_offsets(delta).power_of_ten(exponent) && exponent >= count + 19) {
+        // |delta| <= 2^63 < 10^(exponent - count), so 10^exponent + delta
+        // starts 100...0, or 999...9 just below it.
+        uint64_t leading = 1;
+        for (unsigned int i = 1; i < count; ++i)
+            leading *= 10;
+        return delta >= 0 ? leading : leading * 10 - 1;
+    }
+
+    const Magnitude& m = node->magnitude();
+    if (m.height >= 2)
+        throw std::domain_error("leading digits are beyond the precision of the magnitude estimates");
+
+    if (m.height == 1) {
+        long double log10 = m.x * LOG10_2;
+        long double error = (m.error + ROUNDING * m.x) * LOG10_2;
+        long double whole = std::floor(log10 - error);
+        long double low = std::floor(std::pow(10.0L, log10 - error - whole + count - 1));
+        long double high = std::floor(std::pow(10.0L, log10 + error - whole + count - 1));
+        if (whole == std::floor(log10 + error) && low == high)
+            return (uint64_t) low;
+    }
+
+    if (!node->materializable())
+        throw std::domain_error("leading digits are beyond the precision of the magnitude estimates");
+
+    const Bignum& value = node->materialize();
+    uint64_t digits = decimal_digit_count(value);
+    uint64_t result;
+    if (digits <= count) {
+        to_uint64(value, result);
+        return result;
+    }
+
+    // Largest L with L * 10^(digits - count) <= value.
+    Bignum scale = power_of(Bignum(10), digits - count);
+    uint64_t low = 1;
+    for (unsigned int i = 1; i < count; ++i)
+        low *= 10;
+    uint64_t high = low * 10 - 1;
+    while (low < high) {
+        uint64_t middle = low + (high - low + 1) / 2;
+        if (value < Bignum((int64_t) middle) * scale)
+            high = middle - 1;
+        else
+            low = middle;
+    }
+
+    return low;
+}
+
+uint64_t BignumExpression::trailing_digits(const unsigned int count) const {
+    if (count == 0 || count > 9)
+        throw std::invalid_argument("can only extract between 1 and 9 trailing digits");
+
+    uint32_t modulus = 1;
+    for (unsigned int i = 0; i < count; ++i)
+        modulus *= 10;
+
+    return node->residue(modulus);
+}
+
+const Bignum& BignumExpression::materialize() const {
+    return node->materialize();
+}
+
+bool BignumExpression::is_materialized() const {
+    return node->kind == Node::LITERAL || node->materialized;
+}
+
+bool operator==(const BignumExpression& left, const BignumExpression& right) {
+    return left.compare(right) == 0;
+}
+
+bool operator!=(const BignumExpression& left, const BignumExpression& right) {
+    return !(left == right);
+}
+
+bool operator<(const BignumExpression& left, const BignumExpression& right) {
+    return left.compare(right) < 0;
+}
+
+bool operator<=(const BignumExpression& left, const BignumExpression& right) {
+    return !(left > right);
+}
+
+bool operator>(const BignumExpression& left, const BignumExpression& right) {
+    return right < left;
+}
+
+bool operator>=(const BignumExpression& left, const BignumExpression& right) {
+    return right <= left;
+}
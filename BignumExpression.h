@@ -0,0 +1,52 @@
+#ifndef PHOLSER_BIGNUM_EXPRESSION_H
+#define PHOLSER_BIGNUM_EXPRESSION_H
+
+#include "Bignum.h"
+#include <tr1/cstdint>
+#include <tr1/memory>
+#include <vector>
+
+// A non-negative integer kept in symbolic form -- literals, powers, towers
+// and small offsets thereof -- so that values like 2^p - 1 or 3^^^3 can be
+// compared and measured without being expanded.  Magnitudes are tracked as
+// iterated base-2 logarithms with an error bound; whenever that bound leaves
+// an answer undecided, the value is materialized if it is small enough, and
+// std::domain_error is thrown otherwise.
+class BignumExpression {
+    public:
+        static const uint64_t MATERIALIZE_LIMIT;
+        static const uint64_t MAX_TOWER_HEIGHT;
+
+        BignumExpression(const Bignum&);
+
+        static BignumExpression power(const BignumExpression&, const BignumExpression&);
+        static BignumExpression mersenne(uint64_t);
+        static BignumExpression tower(const std::vector<Bignum>&);
+        static BignumExpression up_arrow(uint64_t, unsigned int, uint64_t);
+        BignumExpression offset(int64_t) const;
+
+        int compare(const BignumExpression&) const;
+        uint64_t bit_length() const;
+        uint64_t digit_count() const;
+        uint64_t leading_digits(unsigned int) const;
+        uint64_t trailing_digits(unsigned int) const;
+
+        const Bignum& materialize() const;
+        bool is_materialized() const;
+
+    private:
+        struct Node;
+
+        std::tr1::shared_ptr<Node> node;
+
+        explicit BignumExpression(const std::tr1::shared_ptr<Node>&);
+};
+
+bool operator==(const BignumExpression&, const BignumExpression&);
+bool operator!=(const BignumExpression&, const BignumExpression&);
+bool operator<(const BignumExpression&, const BignumExpression&);
+bool operator<=(const BignumExpression&, const BignumExpression&);
+bool operator>(const BignumExpression&, const BignumExpression&);
+bool operator>=(const BignumExpression&, const BignumExpression&);
+
+#endif  // PHOLSER_BIGNUM_EXPRESSION_H
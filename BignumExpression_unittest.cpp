@@ -0,0 +1,165 @@
+#include "BignumExpression.h"
+#include "gtest/gtest.h"
+#include <stdexcept>
+#include <vector>
+
+std::vector<Bignum> levels(int height, const Bignum& base) {
+    return std::vector<Bignum>(height, base);
+}
+
+TEST(BignumExpressionTest, ALiteralIsAlreadyMaterialized) {
+    BignumExpression e(Bignum(12345));
+
+    ASSERT_TRUE(e.is_materialized());
+    ASSERT_EQ(Bignum(12345), e.materialize());
+}
+
+TEST(BignumExpressionTest, NegativeLiteralsAreRejected) {
+    ASSERT_THROW(BignumExpression(Bignum(-1)), std::invalid_argument);
+}
+
+TEST(BignumExpressionTest, OffsetsMayNotGoBelowZero) {
+    ASSERT_THROW(BignumExpression(Bignum(3)).offset(-4), std::invalid_argument);
+}
+
+TEST(BignumExpressionTest, PowersMaterializeOnDemandAndCache) {
+    BignumExpression e = BignumExpression::power(Bignum(2), Bignum(100));
+
+    ASSERT_FALSE(e.is_materialized());
+    ASSERT_EQ(Bignum(1) << 100, e.materialize());
+    ASSERT_TRUE(e.is_materialized());
+}
+
+TEST(BignumExpressionTest, MersenneNumberMaterializes) {
+    BignumExpression e = BignumExpression::mersenne(127);
+
+    ASSERT_EQ((Bignum(1) << 127) - Bignum(1), e.materialize());
+}
+
+TEST(BignumExpressionTest, MeasuringAMersenneNumberDoesNotMaterializeIt) {
+    BignumExpression e = BignumExpression::mersenne(82589933);
+
+    ASSERT_EQ(82589933U, e.bit_length());
+    ASSERT_EQ(24862048U, e.digit_count());
+    ASSERT_EQ(14889444U, e.leading_digits(8));
+    ASSERT_EQ(217902591U, e.trailing_digits(9));
+    ASSERT_FALSE(e.is_materialized());
+}
+
+TEST(BignumExpressionTest, DigitsOfSmallValues) {
+    BignumExpression e(Bignum(123456789));
+
+    ASSERT_EQ(9U, e.digit_count());
+    ASSERT_EQ(1234U, e.leading_digits(4));
+    ASSERT_EQ(123456789U, e.leading_digits(12));
+    ASSERT_EQ(6789U, e.trailing_digits(4));
+}
+
+TEST(BignumExpressionTest, DigitsOfHugePowersOfTen) {
+    BignumExpression e = BignumExpression::power(Bignum(100), Bignum(500000));
+
+    ASSERT_EQ(1000001U, e.digit_count());
+    ASSERT_EQ(10000U, e.leading_digits(5));
+    ASSERT_EQ(1000000U, e.offset(-1).digit_count());
+    ASSERT_EQ(99999U, e.offset(-1).leading_digits(5));
+    ASSERT_EQ(1000001U, e.offset(7).digit_count());
+    ASSERT_FALSE(e.is_materialized());
+}
+
+TEST(BignumExpressionTest, BitLengthOfAPowerOfTwoPlusOne) {
+    BignumExpression e = BignumExpression::power(Bignum(4), Bignum(1000)).offset(1);
+
+    ASSERT_EQ(2001U, e.bit_length());
+}
+
+TEST(BignumExpressionTest, TowerEvaluatesRightToLeft) {
+    std::vector<Bignum> values;
+    values.push_back(Bignum(2));
+    values.push_back(Bignum(3));
+    values.push_back(Bignum(2));
+
+    ASSERT_EQ(Bignum(512), BignumExpression::tower(values).materialize());
+}
+
+TEST(BignumExpressionTest, TrailingDigitsOfTowers) {
+    ASSERT_EQ(870132343U, BignumExpression::tower(levels(3, Bignum(7))).trailing_digits(9));
+    ASSERT_EQ(100739387U, BignumExpression::tower(levels(4, Bignum(3))).trailing_digits(9));
+}
+
+TEST(BignumExpressionTest, UpArrows) {
+    ASSERT_EQ(BignumExpression(Bignum(65536)), BignumExpression::up_arrow(2, 2, 4));
+    ASSERT_EQ(BignumExpression(Bignum(4)), BignumExpression::up_arrow(2, 5, 2));
+    ASSERT_EQ(BignumExpression::power(Bignum(3), Bignum(27)), BignumExpression::up_arrow(3, 3, 2));
+}
+
+TEST(BignumExpressionTest, UpArrowExpansionsThatAreTooDeepAreRejected) {
+    ASSERT_THROW(BignumExpression::up_arrow(3, 3, 3), std::length_error);
+}
+
+TEST(BignumExpressionTest, MersenneNumberIsLessThanThePowerOfTwoAboveIt) {
+    BignumExpression m = BignumExpression::mersenne(1000000);
+    BignumExpression p = BignumExpression::power(Bignum(2), Bignum(1000000));
+
+    ASSERT_LT(m, p);
+    ASSERT_GT(p, m);
+    ASSERT_NE(m, p);
+}
+
+TEST(BignumExpressionTest, ComparingTowersOfDifferentHeights) {
+    BignumExpression taller = BignumExpression::tower(levels(6, Bignum(2)));
+    BignumExpression shorter = BignumExpression::tower(levels(3, Bignum(10)));
+
+    ASSERT_LT(shorter, taller);
+}
+
+TEST(BignumExpressionTest, ComparingTowersOfTheSameHeight) {
+    BignumExpression threes = BignumExpression::tower(levels(5, Bignum(3)));
+    BignumExpression fours = BignumExpression::tower(levels(5, Bignum(4)));
+
+    ASSERT_LT(threes, fours);
+}
+
+TEST(BignumExpressionTest, EqualPowersInDifferentForms) {
+    BignumExpression m = BignumExpression::power(Bignum(2), BignumExpression::power(Bignum(2), Bignum(65537)));
+    BignumExpression n = BignumExpression::power(Bignum(4), BignumExpression::power(Bignum(2), Bignum(65536)));
+    BignumExpression p = BignumExpression::power(Bignum(4), Bignum(1LL << 40));
+    BignumExpression q = BignumExpression::power(Bignum(2), Bignum(1LL << 41));
+    BignumExpression r = BignumExpression::power(BignumExpression::power(Bignum(9), Bignum(3)), Bignum(1LL << 40));
+    BignumExpression s = BignumExpression::power(Bignum(27), Bignum(1LL << 41));
+
+    ASSERT_EQ(m, n);
+    ASSERT_LT(m.offset(-1), n);
+    ASSERT_EQ(p, q);
+    ASSERT_GT(p.offset(5), q.offset(4));
+    ASSERT_LT(p, BignumExpression::power(Bignum(2), Bignum((1LL << 41) + 1)));
+    ASSERT_EQ(r, s);
+}
+
+TEST(BignumExpressionTest, ComparisonsBeyondThePrecisionOfTheEstimatesAreRejected) {
+    // 2^65537 * log_3(2), to 30 decimal places, so that 3^exponent is
+    // within a hair of 2^2^65537 but not equal to it.
+    Bignum log_3_of_2 = Bignum(630929753571457LL) * Bignum(1000000000000000LL) + Bignum(437099527114342LL);
+    Bignum exponent = (Bignum(1) << 65537) * log_3_of_2 / (Bignum(1000000000000000LL) * Bignum(1000000000000000LL));
+    BignumExpression m = BignumExpression::power(Bignum(2), BignumExpression::power(Bignum(2), Bignum(65537)));
+    BignumExpression n = BignumExpression::power(Bignum(3), exponent);
+
+    ASSERT_THROW(m.compare(n), std::domain_error);
+}
+
+TEST(BignumExpressionTest, PowersThatDoNotDependOnTheSizeOfTheirOperands) {
+    BignumExpression huge = BignumExpression::tower(levels(6, Bignum(2)));
+
+    ASSERT_EQ(Bignum(1), BignumExpression::power(Bignum(1), huge).materialize());
+    ASSERT_EQ(Bignum(0), BignumExpression::power(Bignum(0), huge).materialize());
+    ASSERT_EQ(Bignum(1), BignumExpression::power(huge, Bignum(0)).materialize());
+    ASSERT_EQ(1U, BignumExpression::power(Bignum(0), Bignum(0)).digit_count());
+    ASSERT_LT(BignumExpression::power(Bignum(1), huge), huge);
+}
+
+TEST(BignumExpressionTest, MeasuringUnimaginablyLargeValues) {
+    BignumExpression e = BignumExpression::tower(levels(6, Bignum(2)));
+
+    ASSERT_THROW(e.bit_length(), std::overflow_error);
+    ASSERT_THROW(e.leading_digits(1), std::domain_error);
+    ASSERT_THROW(e.materialize(), std::length_error);
+}
@@ -0,0 +1,84 @@
+#ifndef PHOLSER_BIGNUM_KERNELS_H
+#define PHOLSER_BIGNUM_KERNELS_H
+
+#include "Bignum.h"
+#include <tr1/cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+// The digit-level routines behind Bignum that other parts of the library
+// drive step by step.  Not part of Bignum's interface: digit vectors are
+// little-endian and carry no sign.
+
+const uint32_t DECIMAL_BIGIT = 1000000000U;
+const unsigned int DECIMAL_DIGITS_IN_BIGIT = 9;
+const std::string::size_type DECIMAL_CHUNK_SIZE = 1 << 16;
+
+// Collects decimal digits and hands them on in fixed-size chunks.
+class DecimalSink {
+    public:
+        DecimalSink() : buffer() {
+            buffer.reserve(DECIMAL_CHUNK_SIZE);
+        }
+
+        virtual ~DecimalSink() {
+        }
+
+        void put(const char* digits, std::string::size_type count) {
+            buffer.append(digits, count);
+            if (buffer.size() >= DECIMAL_CHUNK_SIZE)
+                flush();
+        }
+
+        void put_zeros(std::string::size_type count) {
+            for (; count > 0; --count) {
+                buffer.push_back('0');
+                if (buffer.size() >= DECIMAL_CHUNK_SIZE)
+                    flush();
+            }
+        }
+
+        void flush() {
+            if (!buffer.empty())
+                emit(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+
+    protected:
+        virtual void emit(const char*, std::string::size_type) = 0;
+
+    private:
+        std::string buffer;
+};
+
+// Long division of magnitudes (Knuth, TAOCP vol. 2, 4.3.1, Algorithm D)
+// with its working state kept between calls, so that the quotient can be
+// produced a few digits at a time, most significant first, each digit
+// costing about one pass over the divisor.
+class LongDivision {
+    public:
+        LongDivision(const std::deque<uint32_t>&, const std::deque<uint32_t>&);
+
+        std::deque<uint32_t>::size_type remaining() const;
+        void step(std::deque<uint32_t>::size_type);
+        void finish(std::deque<uint32_t>&, std::deque<uint32_t>&);
+
+    private:
+        std::deque<uint32_t> u;
+        std::deque<uint32_t> v;
+        std::deque<uint32_t> quotient;
+        unsigned int shift_amount;
+        std::deque<uint32_t>::size_type next;
+};
+
+int compare_digits(const std::deque<uint32_t>&, const std::deque<uint32_t>&);
+std::deque<uint32_t> digit_range(const std::deque<uint32_t>&, std::deque<uint32_t>::size_type,
+    std::deque<uint32_t>::size_type);
+void add_shifted(std::deque<uint32_t>&, const std::deque<uint32_t>&, std::deque<uint32_t>::size_type);
+void divide(const std::deque<uint32_t>&, const std::deque<uint32_t>&, std::deque<uint32_t>&,
+    std::deque<uint32_t>&);
+void write_decimal_digits(const std::deque<uint32_t>&, const std::vector<std::deque<uint32_t> >&, int, bool,
+    DecimalSink&);
+
+#endif  // PHOLSER_BIGNUM_KERNELS_H
@@ -0,0 +1,411 @@
+#include "BignumTask.h"
+#include "BignumKernels.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <stdexcept>
+
+const uint64_t BignumTask::STEP_BUDGET = 1 << 18;
+
+Executor::~Executor() {
+}
+
+InlineExecutor::InlineExecutor() : ready(), draining(false) {
+}
+
+void InlineExecutor::schedule(BignumTask& task) {
+    ready.push_back(&task);
+    if (draining)
+        return;
+
+    draining = true;
+    while (!ready.empty()) {
+        BignumTask* next = ready.front();
+        ready.pop_front();
+        next->resume();
+    }
+    draining = false;
+}
+
+TaskListener::~TaskListener() {
+}
+
+void TaskListener::progressed(const BignumTask&) {
+}
+
+void TaskListener::finished(const BignumTask&) {
+}
+
+BignumTask::BignumTask()
+    : executor(0), listener(0), finished(false), cancelled(false), fraction(0) {
+    pthread_mutex_init(&lock, 0);
+}
+
+BignumTask::~BignumTask() {
+    pthread_mutex_destroy(&lock);
+}
+
+void BignumTask::start(Executor& executor) {
+    this->executor = &executor;
+    executor.schedule(*this);
+}
+
+void BignumTask::run() {
+    InlineExecutor inline_executor;
+    start(inline_executor);
+}
+
+void BignumTask::resume() {
+    bool more = !is_cancelled() && advance();
+    if (listener != 0)
+        listener->progressed(*this);
+
+    if (more && !is_cancelled()) {
+        executor->schedule(*this);
+        return;
+    }
+
+    pthread_mutex_lock(&lock);
+    finished = true;
+    if (!cancelled)
+        fraction = 1;
+    pthread_mutex_unlock(&lock);
+
+    if (listener != 0)
+        listener->finished(*this);
+}
+
+void BignumTask::cancel() {
+    pthread_mutex_lock(&lock);
+    if (!finished)
+        cancelled = true;
+    pthread_mutex_unlock(&lock);
+}
+
+void BignumTask::set_listener(TaskListener* listener) {
+    this->listener = listener;
+}
+
+bool BignumTask::is_finished() const {
+    pthread_mutex_lock(&lock);
+    bool result = finished;
+    pthread_mutex_unlock(&lock);
+    return result;
+}
+
+bool BignumTask::is_cancelled() const {
+    pthread_mutex_lock(&lock);
+    bool result = cancelled;
+    pthread_mutex_unlock(&lock);
+    return result;
+}
+
+double BignumTask::progress() const {
+    pthread_mutex_lock(&lock);
+    double result = fraction;
+    pthread_mutex_unlock(&lock);
+    return result;
+}
+
+void BignumTask::set_progress(const double fraction) {
+    pthread_mutex_lock(&lock);
+    this->fraction = fraction;
+    pthread_mutex_unlock(&lock);
+}
+
+void BignumTask::require_finished() const {
+    if (!is_finished() || is_cancelled())
+        throw std::logic_error("task has not finished");
+}
+
+// Collects a DecimalTask's digits into its result.
+class StringDecimalSink : public DecimalSink {
+    public:
+        StringDecimalSink(std::string& digits) : digits(digits) {
+        }
+
+    protected:
+        void emit(const char* chunk, std::string::size_type count) {
+            digits.append(chunk, count);
+        }
+
+    private:
+        std::string& digits;
+};
+
+BlockProduct::BlockProduct() : first(1, 0U), second(1, 0U), sum(1, 0U), row(0), column(0), band(1), sign(0) {
+}
+
+void BlockProduct::begin(const Bignum& first, const Bignum& second) {
+    this->first = first.digits();
+    this->second = second.digits();
+    sum.assign(1, 0U);
+    row = 0;
+    column = 0;
+    sign = first.signum() * second.signum();
+}
+
+// Multiplies in as many tiles of the product as the budget allows, and
+// takes what they cost out of it.  A tile is a band of the first factor's
+// digits times a run of the second's; when the second factor is too wide
+// for whole rows to fit the budget, tiles are cut square, so that they
+// stay balanced enough for Karatsuba.  Each tile's product is added into
+// the running sum where it belongs, touching only the digits it overlaps.
+bool BlockProduct::advance(uint64_t& budget) {
+    const uint64_t width = second.size();
+
+    while (row < first.size() && budget > 0) {
+        if (column == 0) {
+            uint64_t side = std::max<uint64_t>(budget / width, (uint64_t) std::sqrt((double) budget));
+            band = std::min<uint64_t>(first.size() - row, std::max<uint64_t>(1, side));
+        }
+        const uint64_t run = std::min<uint64_t>(width - column, std::max<uint64_t>(1, budget / band));
+
+        std::deque<uint32_t> rows = digit_range(first, row, row + band);
+        std::deque<uint32_t> columns = digit_range(second, column, column + run);
+        if ((rows.size() > 1 || rows[0] != 0U) && (columns.size() > 1 || columns[0] != 0U))
+            add_shifted(sum, (Bignum(rows, 1) * Bignum(columns, 1)).digits(), row + column);
+
+        budget -= std::min<uint64_t>(budget, band * run);
+        column += run;
+        if (column == width) {
+            column = 0;
+            row += band;
+        }
+    }
+
+    return row < first.size();
+}
+
+Bignum BlockProduct::result() const {
+    std::deque<uint32_t> digits(sum);
+    while (digits.size() > 1 && digits.back() == 0U)
+        digits.pop_back();
+    if (digits.size() == 1 && digits[0] == 0U)
+        return Bignum(0);
+
+    return Bignum(digits, sign);
+}
+
+BlockQuotient::BlockQuotient() : division(), width(1), quotient_digits(1, 0U), remainder_digits(1, 0U) {
+}
+
+void BlockQuotient::begin(const std::deque<uint32_t>& dividend, const std::deque<uint32_t>& divisor) {
+    division.reset(new LongDivision(dividend, divisor));
+    width = divisor.size();
+}
+
+// Produces as many quotient digits as the budget allows, each costing
+// about the divisor's width in digit products, and takes what they cost
+// out of it.
+bool BlockQuotient::advance(uint64_t& budget) {
+    if (!division)
+        return false;
+
+    while (division->remaining() > 0 && budget > 0) {
+        uint64_t rows = std::min<uint64_t>(division->remaining(), std::max<uint64_t>(1, budget / width));
+        division->step(rows);
+        budget -= std::min<uint64_t>(budget, rows * width);
+    }
+
+    if (division->remaining() > 0)
+        return true;
+
+    division->finish(quotient_digits, remainder_digits);
+    division.reset();
+    return false;
+}
+
+const std::deque<uint32_t>& BlockQuotient::quotient() const {
+    return quotient_digits;
+}
+
+const std::deque<uint32_t>& BlockQuotient::remainder() const {
+    return remainder_digits;
+}
+
+PowerTask::PowerTask(const Bignum& base, const uint64_t exponent)
+    : base(base), exponent(exponent), bit(-1), top_bit(-1), phase(START), product(), value(1) {
+    for (uint64_t rest = exponent; rest != 0; rest >>= 1)
+        ++top_bit;
+    bit = top_bit;
+}
+
+const Bignum& PowerTask::result() const {
+    require_finished();
+    return value;
+}
+
+// Left-to-right binary powering: square, then multiply by the base
+// wherever the exponent has a one bit.
+bool PowerTask::advance() {
+    uint64_t budget = STEP_BUDGET;
+
+    while (bit >= 0 && budget > 0) {
+        if (phase == START) {
+            product.begin(value, value);
+            phase = SQUARING;
+        }
+
+        if (product.advance(budget))
+            break;
+
+        value = product.result();
+        if (phase == SQUARING && (exponent >> bit) & 1) {
+            product.begin(value, base);
+            phase = MULTIPLYING;
+        } else {
+            phase = START;
+            --bit;
+        }
+    }
+
+    set_progress((double) (top_bit - bit) / (top_bit + 1));
+    return bit >= 0;
+}
+
+DecimalTask::Frame::Frame(const std::deque<uint32_t>& value, const int level, const bool padded)
+    : value(value), level(level), padded(padded) {
+}
+
+DecimalTask::DecimalTask(const Bignum& value)
+    : value(value.abs()), negative(value.signum() < 0), expected_digits(value.bit_length() * 0.30103 + 1),
+      powers(1, std::deque<uint32_t>(1, DECIMAL_BIGIT)), powers_ready(false), square(), squaring(false),
+      pending(), division(), dividing(false), digits() {
+}
+
+const std::string& DecimalTask::result() const {
+    require_finished();
+    return digits;
+}
+
+// The subdivision that write_decimal() does recursively, driven from an
+// explicit stack so that it can stop between frames.  First the powers
+// 10^(9 * 2^i) up to the value are squared out; then each frame writes
+// its value, which is below powers[level]^2, as the frames for its
+// quotient and remainder by powers[level], the remainder padded to full
+// width.  Digits come out most significant first.  Squarings and
+// divisions are carried block by block across steps, so no step runs far
+// past its budget however large the value; frames that fit in what is
+// left of the budget are handed to write_decimal_digits() whole.
+bool DecimalTask::advance() {
+    uint64_t budget = STEP_BUDGET;
+    StringDecimalSink sink(digits);
+
+    while (!powers_ready && budget > 0) {
+        const Bignum power(powers.back(), 1);
+
+        // A square has at least 2b - 1 bits for a b-bit power, so the last,
+        // largest square need not be computed to know it is past the value.
+        bool past_value = 2 * power.bit_length() - 2 >= value.bit_length();
+        if (!past_value) {
+            if (!squaring) {
+                square.begin(power, power);
+                squaring = true;
+            }
+
+            if (square.advance(budget))
+                break;
+
+            squaring = false;
+            Bignum next = square.result();
+            past_value = next > value;
+            if (!past_value)
+                powers.push_back(next.digits());
+        }
+
+        if (past_value) {
+            powers_ready = true;
+            if (negative)
+                sink.put("-", 1);
+            pending.push_back(Frame(value.digits(), (int) powers.size() - 1, false));
+        }
+    }
+
+    while (powers_ready && !pending.empty() && budget > 0) {
+        if (!dividing) {
+            Frame& frame = pending.back();
+            const uint64_t cost = frame.level < 0 ? 1 : std::max<uint64_t>(1,
+                (uint64_t) frame.value.size() * powers[frame.level].size());
+            if (cost <= budget) {
+                write_decimal_digits(frame.value, powers, frame.level, frame.padded, sink);
+                pending.pop_back();
+                budget -= cost;
+                continue;
+            }
+
+            if (!frame.padded && compare_digits(frame.value, powers[frame.level]) < 0) {
+                --frame.level;
+                continue;
+            }
+
+            division.begin(frame.value, powers[frame.level]);
+            dividing = true;
+        }
+
+        if (division.advance(budget))
+            break;
+
+        dividing = false;
+        const int level = pending.back().level;
+        const bool padded = pending.back().padded;
+        pending.pop_back();
+        pending.push_back(Frame(division.remainder(), level - 1, true));
+        pending.push_back(Frame(division.quotient(), level - 1, padded));
+    }
+    sink.flush();
+
+    if (!powers_ready || !pending.empty()) {
+        set_progress(std::min(digits.size() / expected_digits, 1.0));
+        return true;
+    }
+
+    return false;
+}
+
+LucasLehmerTask::LucasLehmerTask(const uint64_t exponent)
+    : exponent(exponent), iteration(0), mersenne(0), residue(4), square(), squaring(false) {
+    if (exponent < 2)
+        throw std::invalid_argument("Lucas-Lehmer needs an exponent of at least 2");
+    if (exponent > UINT_MAX)
+        throw std::length_error("Lucas-Lehmer exponent does not fit in a shift count");
+
+    mersenne = (Bignum(1) << exponent) - Bignum(1);
+}
+
+bool LucasLehmerTask::is_prime() const {
+    require_finished();
+    return exponent == 2 || residue.signum() == 0;
+}
+
+// s <- s^2 - 2 mod 2^p - 1, folding the high bits onto the low ones since
+// 2^p is 1 modulo 2^p - 1.
+bool LucasLehmerTask::advance() {
+    uint64_t budget = STEP_BUDGET;
+
+    while (iteration + 2 < exponent && budget > 0) {
+        if (!squaring) {
+            square.begin(residue, residue);
+            squaring = true;
+        }
+
+        if (square.advance(budget))
+            break;
+
+        squaring = false;
+        residue = square.result() - Bignum(2);
+        if (residue.signum() < 0)
+            residue += mersenne;
+        while (residue.bit_length() > exponent) {
+            Bignum high = residue >> exponent;
+            residue = (residue - (high << exponent)) + high;
+        }
+        if (residue == mersenne)
+            residue = Bignum(0);
+
+        ++iteration;
+    }
+
+    set_progress(exponent > 2 ? (double) iteration / (exponent - 2) : 1.0);
+    return iteration + 2 < exponent;
+}
@@ -0,0 +1,189 @@
+#ifndef PHOLSER_BIGNUM_TASK_H
+#define PHOLSER_BIGNUM_TASK_H
+
+#include "Bignum.h"
+#include <tr1/cstdint>
+#include <tr1/memory>
+#include <deque>
+#include <string>
+#include <vector>
+#include <pthread.h>
+
+class BignumTask;
+class LongDivision;
+
+// Decides where and when a task's steps run.  schedule() is handed a task
+// with more work to do and must eventually call its resume(), on any
+// thread; a task is never scheduled again before that call returns.
+class Executor {
+    public:
+        virtual ~Executor();
+        virtual void schedule(BignumTask&) = 0;
+};
+
+// Runs scheduled tasks to completion on the thread that started them.
+class InlineExecutor : public Executor {
+    public:
+        InlineExecutor();
+
+        void schedule(BignumTask&);
+
+    private:
+        std::deque<BignumTask*> ready;
+        bool draining;
+};
+
+class TaskListener {
+    public:
+        virtual ~TaskListener();
+        virtual void progressed(const BignumTask&);
+        virtual void finished(const BignumTask&);
+};
+
+// A long-running Bignum computation broken into steps of about
+// STEP_BUDGET digit products each.  Between steps the task goes back to
+// its executor, reports progress, and checks for cancellation.  Inputs
+// small enough to finish within one step are done in that step.
+class BignumTask {
+    public:
+        static const uint64_t STEP_BUDGET;
+
+        BignumTask();
+        virtual ~BignumTask();
+
+        void start(Executor&);
+        void run();
+        void resume();
+        void cancel();
+        void set_listener(TaskListener*);
+
+        bool is_finished() const;
+        bool is_cancelled() const;
+        double progress() const;
+
+    protected:
+        virtual bool advance() = 0;
+        void set_progress(double);
+        void require_finished() const;
+
+    private:
+        Executor* executor;
+        TaskListener* listener;
+        mutable pthread_mutex_t lock;
+        bool finished;
+        bool cancelled;
+        double fraction;
+
+        BignumTask(const BignumTask&);
+        BignumTask& operator=(const BignumTask&);
+};
+
+// A product computed a tile of digit products at a time.
+class BlockProduct {
+    public:
+        BlockProduct();
+
+        void begin(const Bignum&, const Bignum&);
+        bool advance(uint64_t&);
+        Bignum result() const;
+
+    private:
+        std::deque<uint32_t> first;
+        std::deque<uint32_t> second;
+        std::deque<uint32_t> sum;
+        std::deque<uint32_t>::size_type row;
+        std::deque<uint32_t>::size_type column;
+        std::deque<uint32_t>::size_type band;
+        int sign;
+};
+
+// A quotient and remainder of magnitudes computed a block of quotient
+// digits at a time, most significant first, by long division.
+class BlockQuotient {
+    public:
+        BlockQuotient();
+
+        void begin(const std::deque<uint32_t>&, const std::deque<uint32_t>&);
+        bool advance(uint64_t&);
+        const std::deque<uint32_t>& quotient() const;
+        const std::deque<uint32_t>& remainder() const;
+
+    private:
+        std::tr1::shared_ptr<LongDivision> division;
+        uint64_t width;
+        std::deque<uint32_t> quotient_digits;
+        std::deque<uint32_t> remainder_digits;
+};
+
+class PowerTask : public BignumTask {
+    public:
+        PowerTask(const Bignum&, uint64_t);
+
+        const Bignum& result() const;
+
+    protected:
+        bool advance();
+
+    private:
+        enum Phase { START, SQUARING, MULTIPLYING };
+
+        Bignum base;
+        uint64_t exponent;
+        int bit;
+        int top_bit;
+        Phase phase;
+        BlockProduct product;
+        Bignum value;
+};
+
+class DecimalTask : public BignumTask {
+    public:
+        DecimalTask(const Bignum&);
+
+        const std::string& result() const;
+
+    protected:
+        bool advance();
+
+    private:
+        struct Frame {
+            Frame(const std::deque<uint32_t>&, int, bool);
+
+            std::deque<uint32_t> value;
+            int level;
+            bool padded;
+        };
+
+        Bignum value;
+        bool negative;
+        double expected_digits;
+        std::vector<std::deque<uint32_t> > powers;
+        bool powers_ready;
+        BlockProduct square;
+        bool squaring;
+        std::vector<Frame> pending;
+        BlockQuotient division;
+        bool dividing;
+        std::string digits;
+};
+
+// Lucas-Lehmer test of the Mersenne number 2^p - 1, for prime p.
+class LucasLehmerTask : public BignumTask {
+    public:
+        LucasLehmerTask(uint64_t);
+
+        bool is_prime() const;
+
+    protected:
+        bool advance();
+
+    private:
+        uint64_t exponent;
+        uint64_t iteration;
+        Bignum mersenne;
+        Bignum residue;
+        BlockProduct square;
+        bool squaring;
+};
+
+#endif  // PHOLSER_BIGNUM_TASK_H
@@ -0,0 +1,225 @@
+#include "BignumTask.h"
+#include "gtest/gtest.h"
+#include <deque>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+// Holds scheduled tasks until the test resumes them by hand.
+class ManualExecutor : public Executor {
+    public:
+        ManualExecutor() : scheduled(0) {
+        }
+
+        void schedule(BignumTask& task) {
+            ++scheduled;
+            ready.push_back(&task);
+        }
+
+        bool resume_next() {
+            if (ready.empty())
+                return false;
+
+            BignumTask* next = ready.front();
+            ready.pop_front();
+            next->resume();
+            return true;
+        }
+
+        int scheduled;
+        std::deque<BignumTask*> ready;
+};
+
+class CountingListener : public TaskListener {
+    public:
+        CountingListener() : progressed_count(0), finished_count(0) {
+        }
+
+        void progressed(const BignumTask&) {
+            ++progressed_count;
+        }
+
+        void finished(const BignumTask&) {
+            ++finished_count;
+        }
+
+        int progressed_count;
+        int finished_count;
+};
+
+Bignum repeated_product(int64_t base, int exponent) {
+    Bignum result(1);
+    for (int i = 0; i < exponent; ++i)
+        result *= Bignum(base);
+
+    return result;
+}
+
+TEST(BignumTaskTest, PowerRunsToCompletion) {
+    PowerTask task(Bignum(-3), 1001);
+    task.run();
+
+    ASSERT_TRUE(task.is_finished());
+    ASSERT_EQ(1.0, task.progress());
+    ASSERT_EQ(-repeated_product(3, 1001), task.result());
+}
+
+TEST(BignumTaskTest, PowerOfZeroExponent) {
+    PowerTask task(Bignum(12345), 0);
+    task.run();
+
+    ASSERT_EQ(Bignum(1), task.result());
+}
+
+TEST(BignumTaskTest, ShortOperationsFinishInOneStep) {
+    ManualExecutor executor;
+    PowerTask task(Bignum(7), 100);
+    task.start(executor);
+    executor.resume_next();
+
+    ASSERT_EQ(1, executor.scheduled);
+    ASSERT_TRUE(task.is_finished());
+}
+
+TEST(BignumTaskTest, LongOperationsYieldToTheExecutorAndReportProgress) {
+    ManualExecutor executor;
+    CountingListener listener;
+    PowerTask task(Bignum(3), 200000);
+    task.set_listener(&listener);
+    task.start(executor);
+
+    double last_progress = 0;
+    while (executor.resume_next()) {
+        ASSERT_LE(last_progress, task.progress());
+        last_progress = task.progress();
+    }
+
+    ASSERT_LT(1, executor.scheduled);
+    ASSERT_EQ(executor.scheduled, listener.progressed_count);
+    ASSERT_EQ(1, listener.finished_count);
+    ASSERT_EQ(1.0, task.progress());
+    ASSERT_EQ(316993U, task.result().bit_length());
+}
+
+TEST(BignumTaskTest, CancellationTakesEffectAtTheNextStep) {
+    ManualExecutor executor;
+    CountingListener listener;
+    PowerTask task(Bignum(3), 200000);
+    task.set_listener(&listener);
+    task.start(executor);
+    executor.resume_next();
+    task.cancel();
+    while (executor.resume_next());
+
+    ASSERT_TRUE(task.is_finished());
+    ASSERT_TRUE(task.is_cancelled());
+    ASSERT_EQ(1, listener.finished_count);
+    ASSERT_THROW(task.result(), std::logic_error);
+}
+
+TEST(BignumTaskTest, ResultsAreUnavailableBeforeFinishing) {
+    PowerTask task(Bignum(2), 10);
+
+    ASSERT_THROW(task.result(), std::logic_error);
+}
+
+TEST(BignumTaskTest, DecimalConversion) {
+    Bignum value = repeated_product(10, 3000) + Bignum(7);
+    std::ostringstream expected;
+    expected << -value;
+    DecimalTask task(-value);
+    task.run();
+
+    ASSERT_EQ(expected.str(), task.result());
+}
+
+TEST(BignumTaskTest, DecimalConversionAcrossManySteps) {
+    Bignum value = (Bignum(3) << 200000) - 1;
+    std::ostringstream expected;
+    expected << value;
+
+    ManualExecutor executor;
+    DecimalTask task(value);
+    task.start(executor);
+    double last_progress = 0;
+    while (executor.resume_next()) {
+        ASSERT_LE(last_progress, task.progress());
+        last_progress = task.progress();
+    }
+
+    ASSERT_LT(1, executor.scheduled);
+    ASSERT_EQ(expected.str(), task.result());
+}
+
+TEST(BignumTaskTest, DecimalConversionPadsInnerZeros) {
+    Bignum value = repeated_product(10, 500) + Bignum(1);
+    DecimalTask task(value);
+    task.run();
+
+    ASSERT_EQ("1" + std::string(499, '0') + "1", task.result());
+}
+
+TEST(BignumTaskTest, DecimalConversionOfZero) {
+    DecimalTask task(Bignum(0));
+    task.run();
+
+    ASSERT_EQ("0", task.result());
+}
+
+TEST(BignumTaskTest, LucasLehmerFindsMersennePrimes) {
+    unsigned int exponents[] = { 2, 3, 5, 7, 13, 17, 19, 31, 61, 89, 107, 127, 521 };
+    for (unsigned int i = 0; i < sizeof(exponents) / sizeof(exponents[0]); ++i) {
+        LucasLehmerTask task(exponents[i]);
+        task.run();
+
+        ASSERT_TRUE(task.is_prime()) << exponents[i];
+    }
+}
+
+TEST(BignumTaskTest, LucasLehmerRejectsMersenneComposites) {
+    unsigned int exponents[] = { 11, 23, 29, 37, 41, 43, 47, 53, 59, 67, 523 };
+    for (unsigned int i = 0; i < sizeof(exponents) / sizeof(exponents[0]); ++i) {
+        LucasLehmerTask task(exponents[i]);
+        task.run();
+
+        ASSERT_FALSE(task.is_prime()) << exponents[i];
+    }
+}
+
+TEST(BignumTaskTest, LucasLehmerRejectsExponentsBeyondShiftCounts) {
+    ASSERT_THROW(LucasLehmerTask task(1), std::invalid_argument);
+    ASSERT_THROW(LucasLehmerTask task((1ULL << 32) + 15), std::length_error);
+}
+
+TEST(BignumTaskTest, BlockQuotientAgreesWithDivision) {
+    Bignum dividend = (Bignum(3) << 20000) - Bignum(1);
+    Bignum divisor = repeated_product(10, 1500) + Bignum(12345);
+
+    BlockQuotient division;
+    division.begin(dividend.digits(), divisor.digits());
+    int steps = 0;
+    for (bool more = true; more; ++steps) {
+        uint64_t budget = 1000;
+        more = division.advance(budget);
+    }
+
+    ASSERT_LT(1, steps);
+    ASSERT_EQ(dividend / divisor, Bignum(division.quotient(), 1));
+    ASSERT_EQ(dividend - dividend / divisor * divisor, Bignum(division.remainder(), 1));
+}
+
+TEST(BignumTaskTest, BlockProductAgreesWithMultiplicationAcrossTiles) {
+    Bignum first = -((Bignum(5) << 9000) + repeated_product(7, 1000));
+    Bignum second = (Bignum(3) << 12000) - Bignum(1);
+
+    BlockProduct product;
+    product.begin(first, second);
+    int steps = 0;
+    for (bool more = true; more; ++steps) {
+        uint64_t budget = 1000;
+        more = product.advance(budget);
+    }
+
+    ASSERT_LT(1, steps);
+    ASSERT_EQ(first * second, product.result());
+}
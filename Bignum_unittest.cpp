@@ -1,8 +1,14 @@
 #include "Bignum.h"
+#include "RandomBignum.h"
 #include "gtest/gtest.h"
 #include <deque>
 #include <tr1/cstdint>
 #include <cstdarg>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tr1/unordered_set>
 
 std::deque<uint32_t> d(int num_digits, ...) {
     std::deque<uint32_t> digits;
@@ -16,6 +22,20 @@ std::deque<uint32_t> d(int num_digits, ...) {
     return digits;
 }
 
+Bignum power(int64_t base, int exponent) {
+    Bignum result(1);
+    for (int i = 0; i < exponent; ++i)
+        result *= Bignum(base);
+
+    return result;
+}
+
+std::string decimal(const Bignum& n) {
+    std::ostringstream out;
+    out << n;
+    return out.str();
+}
+
 TEST(BignumTest, ConstructingABignumFromAPositiveInt) {
     Bignum n(123456);
 
@@ -520,6 +540,58 @@ TEST(BignumTest, RightShiftByOneBigitSizePlusOneWithAssignment) {
     ASSERT_EQ(Bignum(d(3, 0x6ECC0945U, 0x81820283U, 0x480977FBU), 1), m);
 }
 
+TEST(BignumTest, RightShiftDropsEmptiedLeadingBigits) {
+    Bignum m(d(2, 0x00000000U, 0x00000001U), 1);
+    Bignum n(m >> 1);
+
+    ASSERT_EQ(1U, n.digits().size());
+    ASSERT_EQ(Bignum(0x80000000LL), n);
+    ASSERT_EQ(Bignum(2863311530LL), (Bignum(1) << 63) / (n + 0x40000000));
+}
+
+TEST(BignumTest, RightShiftPastTheLastBigit) {
+    Bignum m(d(2, 0x981743CEU, 0xDD98128AU), -1);
+    m >>= 100;
+
+    ASSERT_EQ(Bignum(0), m);
+    ASSERT_EQ(0, m.signum());
+}
+
+TEST(BignumTest, LeftShiftOfZeroStaysZero) {
+    Bignum n(Bignum(0) << 64);
+
+    ASSERT_EQ(1U, n.digits().size());
+    ASSERT_EQ(Bignum(0), n);
+}
+
+TEST(BignumTest, IntegerSquareRoots) {
+    Bignum n = (Bignum(1) << 200) + 12345;
+
+    ASSERT_EQ(Bignum(0), integer_square_root(Bignum(0)));
+    ASSERT_EQ(Bignum(3), integer_square_root(Bignum(15)));
+    ASSERT_EQ(Bignum(4), integer_square_root(Bignum(16)));
+    ASSERT_EQ(Bignum(1) << 100, integer_square_root(n));
+    ASSERT_EQ(n, integer_square_root(n * n + n + n));
+    ASSERT_THROW(integer_square_root(Bignum(-4)), std::domain_error);
+}
+
+TEST(BignumTest, Powers) {
+    ASSERT_EQ(Bignum(1), power_of(Bignum(0), 0));
+    ASSERT_EQ(Bignum(0), power_of(Bignum(0), 5));
+    ASSERT_EQ(Bignum(-243), power_of(Bignum(-3), 5));
+    ASSERT_EQ(Bignum(81), power_of(Bignum(-3), 4));
+    ASSERT_EQ(Bignum(1) << 1000, power_of(Bignum(2), 1000));
+    ASSERT_EQ(power_of(Bignum(10), 40) * power_of(Bignum(10), 60), power_of(Bignum(100), 50));
+}
+
+TEST(BignumTest, WordPowersModulo) {
+    ASSERT_EQ(0U, word_power_mod(5, 0, 1));
+    ASSERT_EQ(1U, word_power_mod(0, 0, 7));
+    ASSERT_EQ(2U, word_power_mod(2, 10, 7));
+    ASSERT_EQ(1U, word_power_mod(3, 4294967290ULL, 4294967291U));
+    ASSERT_EQ(445U, word_power_mod(4, 13, 497));
+}
+
 TEST(BignumTest, LeftShiftSingleDigitByOne) {
     Bignum m(d(1, 0x12345678U), 1);
     Bignum n(m << 1);
@@ -619,3 +691,587 @@ TEST(BignumTest, LeftShiftByOneBigitSizePlusOneWithAssignment) {
         Bignum(d(6, 0x00000000U, 0x302E879CU, 0xBB302515U, 0x06080A0DU, 0x2025DFEEU, 0x00000001U), 1),
         m);
 }
+
+TEST(BignumTest, ConstructingABignumFromAnIntWiderThanOneBigit) {
+    Bignum n(-5000000000LL);
+
+    ASSERT_EQ(Bignum(d(2, 0x2A05F200U, 0x00000001U), -1), n);
+}
+
+TEST(BignumTest, SimpleMultiplication) {
+    Bignum m(d(1, 6U), 1);
+    Bignum n(d(1, 7U), 1);
+
+    ASSERT_EQ(Bignum(d(1, 42U), 1), m * n);
+}
+
+TEST(BignumTest, MultiplicationCarriesIntoNewBigits) {
+    Bignum m(d(2, 0xFFFFFFFFU, 0xFFFFFFFFU), 1);
+    Bignum n(d(1, 0xFFFFFFFFU), 1);
+
+    ASSERT_EQ(Bignum(d(3, 0x00000001U, 0xFFFFFFFFU, 0xFFFFFFFEU), 1), m * n);
+}
+
+TEST(BignumTest, MultiplicationOfMixedSignsWithAssignment) {
+    Bignum m(d(2, 0x00000000U, 0x00000001U), -1);
+    m *= Bignum(d(1, 3U), 1);
+
+    ASSERT_EQ(Bignum(d(2, 0x00000000U, 0x00000003U), -1), m);
+}
+
+TEST(BignumTest, MultiplicationByZero) {
+    Bignum m(d(3, 0x1U, 0x2U, 0x3U), -1);
+
+    ASSERT_EQ(Bignum(d(1, 0U), 0), m * Bignum(d(1, 0U), 0));
+}
+
+TEST(BignumTest, BitLength) {
+    ASSERT_EQ(0U, Bignum(d(1, 0U), 0).bit_length());
+    ASSERT_EQ(1U, Bignum(d(1, 1U), -1).bit_length());
+    ASSERT_EQ(65U, Bignum(d(3, 0x0U, 0x0U, 0x1U), 1).bit_length());
+}
+
+TEST(BignumTest, RemainderBySingleBigit) {
+    Bignum m(d(3, 0x89ABCDEFU, 0x01234567U, 0x00000001U), 1);
+
+    ASSERT_EQ(224932200U, m.remainder(1000000007U));
+    ASSERT_EQ(m.remainder(1000000007U), (-m).remainder(1000000007U));
+}
+
+TEST(BignumTest, ThreeWayComparison) {
+    Bignum m(d(2, 0x00000001U, 0x00000002U), 1);
+    Bignum n(d(2, 0xFFFFFFFFU, 0x00000001U), 1);
+
+    ASSERT_EQ(1, m.compare(n));
+    ASSERT_EQ(-1, n.compare(m));
+    ASSERT_EQ(0, m.compare(Bignum(m)));
+    ASSERT_EQ(-1, (-m).compare(-n));
+}
+
+TEST(BignumTest, ShorterPositiveNumberIsNotLessThanLongerNegativeNumber) {
+    Bignum m(d(1, 5U), 1);
+    Bignum n(d(2, 0x00000000U, 0x00000001U), -1);
+
+    ASSERT_GT(m, n);
+    ASSERT_LT(n, m);
+}
+
+TEST(BignumTest, LongerPositiveNumberIsGreaterThanShorterPositiveNumber) {
+    Bignum m(d(3, 0x00000000U, 0x00000000U, 0x00000001U), 1);
+    Bignum n(d(1, 0xFFFFFFFFU), 1);
+
+    ASSERT_GT(m, n);
+    ASSERT_FALSE(m < n);
+}
+
+TEST(BignumTest, ComparisonStopsAtFirstDifferingHighBigit) {
+    Bignum m(d(3, 0x00000000U, 0x00000000U, 0x00000002U), 1);
+    Bignum n(d(3, 0xFFFFFFFFU, 0xFFFFFFFFU, 0x00000001U), 1);
+
+    ASSERT_GT(m, n);
+    ASSERT_LT(-m, -n);
+}
+
+TEST(BignumTest, ZeroComparesBetweenNegativeAndPositive) {
+    Bignum zero(d(1, 0U), 0);
+
+    ASSERT_LT(Bignum(-1), zero);
+    ASSERT_LT(zero, Bignum(1));
+    ASSERT_EQ(0, zero.compare(Bignum(0)));
+}
+
+TEST(BignumTest, EqualBignumsHashAlike) {
+    Bignum m(d(3, 0x1U, 0x2U, 0x3U), 1);
+    Bignum n(d(3, 0x1U, 0x2U, 0x3U), 1);
+
+    ASSERT_EQ(m.hash(), n.hash());
+    ASSERT_EQ(std::tr1::hash<Bignum>()(m), std::tr1::hash<Bignum>()(n));
+}
+
+TEST(BignumTest, HashDependsOnSignAndBigitOrder) {
+    Bignum m(d(2, 0x1U, 0x2U), 1);
+
+    ASSERT_NE(m.hash(), (-m).hash());
+    ASSERT_NE(m.hash(), Bignum(d(2, 0x2U, 0x1U), 1).hash());
+}
+
+TEST(BignumTest, BignumsCanKeyHashTables) {
+    std::tr1::unordered_set<Bignum> seen;
+    seen.insert(Bignum(1) << 100);
+    seen.insert(Bignum(42));
+
+    ASSERT_EQ(1U, seen.count(Bignum(1) << 100));
+    ASSERT_EQ(0U, seen.count(Bignum(-42)));
+}
+
+TEST(BignumTest, SimpleDivision) {
+    ASSERT_EQ(Bignum(6), Bignum(42) / Bignum(7));
+    ASSERT_EQ(Bignum(0), Bignum(41) % Bignum(41));
+}
+
+TEST(BignumTest, DivisionTruncatesTowardZero) {
+    ASSERT_EQ(Bignum(-3), Bignum(-7) / Bignum(2));
+    ASSERT_EQ(Bignum(-1), Bignum(-7) % Bignum(2));
+    ASSERT_EQ(Bignum(-3), Bignum(7) / Bignum(-2));
+    ASSERT_EQ(Bignum(1), Bignum(7) % Bignum(-2));
+}
+
+TEST(BignumTest, DivisionOfSmallerByLargerWithAssignment) {
+    Bignum m(d(1, 5U), 1);
+    m /= Bignum(d(2, 0U, 1U), 1);
+
+    ASSERT_EQ(Bignum(d(1, 0U), 0), m);
+}
+
+TEST(BignumTest, DivisionByZero) {
+    ASSERT_THROW(Bignum(1) / Bignum(0), std::domain_error);
+}
+
+TEST(BignumTest, MultipleBigitDivision) {
+    Bignum m = power(3, 200);
+    Bignum n = power(7, 50);
+
+    ASSERT_EQ("147689269781346654697366079240021362541982658661987020", decimal(m / n));
+    ASSERT_EQ("1043054234746676783066714664998769142256021", decimal(m % n));
+}
+
+TEST(BignumTest, QuotientTimesDivisorPlusRemainderIsDividend) {
+    RandomBignum random(0x2545F4914F6CDD1DULL);
+    for (int trial = 0; trial < 200; ++trial) {
+        std::deque<uint32_t> dividend_digits;
+        std::deque<uint32_t> divisor_digits;
+        for (int i = 0; i < 2 + trial % 9; ++i)
+            dividend_digits.push_back(trial % 3 == 0 ? 0xFFFFFFFFU : (uint32_t) (random.next() >> 32));
+        for (int i = 0; i < 2 + trial % 4; ++i)
+            divisor_digits.push_back(i == 0 ? 1U : (uint32_t) (random.next() >> 40) | (trial % 2 ? 0x80000000U : 0U));
+        Bignum dividend(dividend_digits, 1);
+        Bignum divisor(divisor_digits, 1);
+
+        Bignum remainder = dividend % divisor;
+        ASSERT_EQ(dividend, dividend / divisor * divisor + remainder);
+        ASSERT_LT(remainder, divisor);
+    }
+}
+
+TEST(BignumTest, PrintingSmallValuesInDecimal) {
+    ASSERT_EQ("0", decimal(Bignum(0)));
+    ASSERT_EQ("-345", decimal(Bignum(-345)));
+    ASSERT_EQ("1000000000", decimal(Bignum(1000000000)));
+    ASSERT_EQ("18446744073709551616", decimal(Bignum(d(3, 0U, 0U, 1U), 1)));
+}
+
+TEST(BignumTest, PrintingLargeValuesInDecimal) {
+    ASSERT_EQ(
+        "136891479058588375991326027382088315966463695625337436471480190078368997177499076593800206155688941388250484440597994042813512732765695774566001",
+        decimal(power(3, 300)));
+    ASSERT_EQ(
+        "-136891479058588375991326027382088315966463695625337436471480190078368997177499076593800206155688941388250484440597994042813512732765695774566001",
+        decimal(-power(3, 300)));
+}
+
+TEST(BignumTest, PrintingPadsInnerRunsOfZerosAndNines) {
+    Bignum ten_to_the_thousand = power(10, 1000);
+
+    ASSERT_EQ("1" + std::string(1000, '0'), decimal(ten_to_the_thousand));
+    ASSERT_EQ(std::string(1000, '9'), decimal(ten_to_the_thousand - Bignum(1)));
+    ASSERT_EQ("1" + std::string(999, '0') + "1", decimal(ten_to_the_thousand + Bignum(1)));
+}
+
+TEST(BignumTest, PrintingToAFileDescriptor) {
+    std::FILE* file = std::tmpfile();
+    write_decimal(fileno(file), -power(10, 100));
+
+    char contents[128] = { 0 };
+    std::rewind(file);
+    std::size_t length = std::fread(contents, 1, sizeof(contents) - 1, file);
+    std::fclose(file);
+
+    ASSERT_EQ("-1" + std::string(100, '0'), std::string(contents, length));
+}
+
+TEST(BignumTest, AddingANativeIntegerCarriesAcrossBigits) {
+    Bignum m(d(3, 0xFFFFFFFFU, 0xFFFFFFFFU, 0x00000007U), 1);
+    m += 1;
+
+    ASSERT_EQ(Bignum(d(3, 0x00000000U, 0x00000000U, 0x00000008U), 1), m);
+}
+
+TEST(BignumTest, SubtractingFromZeroNegates) {
+    ASSERT_EQ(Bignum(-10858), Bignum(0) - Bignum(10858));
+    ASSERT_EQ(Bignum(7), Bignum(0) - Bignum(-7));
+    ASSERT_EQ(-1, (Bignum(0) - (Bignum(1) << 600)).signum());
+    ASSERT_EQ(Bignum(7), (Bignum(7) + Bignum(-7)) - Bignum(-7));
+}
+
+TEST(BignumTest, MixingInEveryIntegralType) {
+    Bignum n(100);
+    const std::size_t size = 7;
+    const short small = -2;
+    const unsigned char byte = 3;
+
+    ASSERT_EQ(Bignum(103), n + 3u);
+    ASSERT_EQ(Bignum(95), n - 5LL);
+    ASSERT_EQ(Bignum(700), n * size);
+    ASSERT_EQ(Bignum(25), n / 4UL);
+    ASSERT_EQ(Bignum(98), n + small);
+    ASSERT_EQ(Bignum(300), n * byte);
+    ASSERT_EQ(Bignum(-100), n * -1L);
+    ASSERT_EQ(Bignum(50), n / 2ULL);
+    ASSERT_TRUE(n == 100U);
+    ASSERT_TRUE(n != 0LL);
+    ASSERT_TRUE(n > 99UL);
+    ASSERT_TRUE(n < 18446744073709551615ULL);
+    ASSERT_TRUE(n >= (long) 100);
+    ASSERT_TRUE(n <= 'd');
+    ASSERT_EQ(0, Bignum(0).compare(0U));
+
+    Bignum m(1);
+    m += 2U;
+    m -= 1LL;
+    m *= 9ULL;
+    m /= 6UL;
+    m += (unsigned short) 4;
+    ASSERT_EQ(Bignum(7), m);
+}
+
+TEST(BignumTest, SubtractingANativeIntegerBorrowsAcrossBigits) {
+    Bignum m(d(4, 0x00000000U, 0x00000000U, 0x00000000U, 0x00000001U), 1);
+    m -= (int64_t) 1;
+
+    ASSERT_EQ(Bignum(d(3, 0xFFFFFFFFU, 0xFFFFFFFFU, 0xFFFFFFFFU), 1), m);
+}
+
+TEST(BignumTest, NativeAdditionAndSubtractionCrossZero) {
+    ASSERT_EQ(Bignum(-2), Bignum(3) - 5);
+    ASSERT_EQ(Bignum(7), Bignum(-3) + (int64_t) 10);
+    ASSERT_EQ(0, (Bignum(-3) + 3).signum());
+    ASSERT_EQ(Bignum(d(2, 0xFFFFFFFEU, 0xFFFFFFFFU), -1), Bignum(1) - UINT64_MAX);
+}
+
+TEST(BignumTest, NativeAdditionOfExtremeValues) {
+    ASSERT_EQ(Bignum(d(3, 0U, 0U, 1U), 1), Bignum(1) + UINT64_MAX);
+    ASSERT_EQ(Bignum(d(2, 0U, 0x80000000U), -1), Bignum(0) + INT64_MIN);
+    ASSERT_EQ(Bignum(d(2, 0U, 0x80000000U), 1), Bignum(0) - INT64_MIN);
+}
+
+TEST(BignumTest, ComparingWithNativeIntegers) {
+    Bignum two_to_the_64(d(3, 0U, 0U, 1U), 1);
+
+    ASSERT_TRUE(Bignum(-5) < 3);
+    ASSERT_TRUE(Bignum(-5) < (int64_t) -4);
+    ASSERT_TRUE(Bignum(-5) > INT64_MIN);
+    ASSERT_TRUE(two_to_the_64 > UINT64_MAX);
+    ASSERT_TRUE(two_to_the_64 - 1 == UINT64_MAX);
+    ASSERT_TRUE(-two_to_the_64 < INT64_MIN);
+    ASSERT_TRUE(Bignum(0) == 0);
+    ASSERT_TRUE(Bignum(0) >= (uint64_t) 0);
+    ASSERT_TRUE(Bignum(7) != 8);
+    ASSERT_TRUE(Bignum(7) <= 7);
+}
+
+TEST(BignumTest, MultiplyingByNativeIntegers) {
+    Bignum m(d(2, 0x80000000U, 0x80000000U), 1);
+
+    ASSERT_EQ(Bignum(d(3, 0x80000000U, 0x80000001U, 0x00000001U), 1), m * 3);
+    ASSERT_EQ(Bignum(d(3, 0x00000000U, 0x00000001U, 0x00000001U), -1), m * (int64_t) -2);
+    ASSERT_EQ(m * Bignum(d(2, 0U, 1U), 1), m * (uint64_t) 0x100000000ULL);
+    ASSERT_EQ(0, (m * 0).signum());
+}
+
+TEST(BignumTest, DividingByNativeIntegers) {
+    Bignum m(d(3, 0x89ABCDEFU, 0x01234567U, 0x00000001U), 1);
+
+    ASSERT_EQ(m / Bignum(7), m / 7);
+    ASSERT_EQ(m / Bignum(-7), m / (int64_t) -7);
+    ASSERT_EQ(m / Bignum(d(2, 1U, 1U), 1), m / (uint64_t) 0x100000001ULL);
+    ASSERT_THROW(m / 0, std::domain_error);
+}
+
+TEST(BignumTest, IncrementAcrossABigitBoundary) {
+    Bignum m(d(1, 0xFFFFFFFFU), 1);
+    ++m;
+
+    ASSERT_EQ(Bignum(d(2, 0U, 1U), 1), m);
+}
+
+TEST(BignumTest, DecrementThroughZero) {
+    Bignum m(1);
+    --m;
+    ASSERT_EQ(0, m.signum());
+    --m;
+
+    ASSERT_EQ(Bignum(-1), m);
+}
+
+TEST(BignumTest, BitwiseOperationsMatchNativeTwosComplement) {
+    const int64_t values[] = {
+        0, 1, -1, 2, -2, 255, -256, 0x7FFFFFFFLL, -0x80000000LL, 0x100000000LL, -0x100000000LL,
+        0x123456789ABCLL, -0x123456789ABCLL, INT64_MAX, INT64_MIN + 1
+    };
+    const int count = sizeof(values) / sizeof(values[0]);
+
+    for (int i = 0; i < count; ++i) {
+        ASSERT_EQ(Bignum(~values[i]), ~Bignum(values[i]));
+        for (int j = 0; j < count; ++j) {
+            ASSERT_EQ(Bignum(values[i] & values[j]), Bignum(values[i]) & Bignum(values[j])) << i << " " << j;
+            ASSERT_EQ(Bignum(values[i] | values[j]), Bignum(values[i]) | Bignum(values[j])) << i << " " << j;
+            ASSERT_EQ(Bignum(values[i] ^ values[j]), Bignum(values[i]) ^ Bignum(values[j])) << i << " " << j;
+        }
+    }
+}
+
+TEST(BignumTest, BitwiseOperationsOnWideValues) {
+    Bignum a = (Bignum(1) << 200) - 1;
+    Bignum b = Bignum(1) << 100;
+
+    ASSERT_EQ(b, a & b);
+    ASSERT_EQ(a, a | b);
+    ASSERT_EQ(a - b, a ^ b);
+    ASSERT_EQ(Bignum(0), a & -(Bignum(1) << 200));
+    ASSERT_EQ(-(Bignum(1) << 100), -b & -b);
+    ASSERT_EQ(Bignum(-1), -a | b | a);
+    ASSERT_EQ(b - 1, (-b ^ a) & a);
+}
+
+TEST(BignumTest, BitwiseAssignmentIsSafeWhenAliased) {
+    Bignum n(-12345);
+    n &= n;
+    ASSERT_EQ(Bignum(-12345), n);
+    n ^= n;
+    ASSERT_EQ(Bignum(0), n);
+    ASSERT_EQ(0, n.signum());
+}
+
+TEST(BignumTest, TestingBits) {
+    Bignum n = (Bignum(1) << 100) + 5;
+
+    ASSERT_TRUE(n.test_bit(0));
+    ASSERT_FALSE(n.test_bit(1));
+    ASSERT_TRUE(n.test_bit(2));
+    ASSERT_TRUE(n.test_bit(100));
+    ASSERT_FALSE(n.test_bit(101));
+    ASSERT_FALSE(n.test_bit(100000));
+}
+
+TEST(BignumTest, TestingBitsOfNegativeValuesInTwosComplement) {
+    Bignum n = -(Bignum(1) << 64);
+
+    for (uint64_t bit = 0; bit < 64; ++bit)
+        ASSERT_FALSE(n.test_bit(bit));
+    ASSERT_TRUE(n.test_bit(64));
+    ASSERT_TRUE(n.test_bit(65));
+    ASSERT_TRUE(n.test_bit(100000));
+    ASSERT_TRUE(Bignum(-6).test_bit(1));
+    ASSERT_FALSE(Bignum(-6).test_bit(0));
+    ASSERT_FALSE(Bignum(-6).test_bit(2));
+}
+
+TEST(BignumTest, SettingAndClearingBits) {
+    Bignum n(0);
+    n.set_bit(70);
+    n.set_bit(3);
+    ASSERT_EQ((Bignum(1) << 70) + 8, n);
+
+    n.clear_bit(70);
+    ASSERT_EQ(Bignum(8), n);
+    ASSERT_EQ(1U, n.digits().size());
+    n.clear_bit(3);
+    ASSERT_EQ(0, n.signum());
+    n.clear_bit(500);
+    ASSERT_EQ(Bignum(0), n);
+
+    Bignum m(-8);
+    m.set_bit(0);
+    ASSERT_EQ(Bignum(-7), m);
+    m.clear_bit(3);
+    ASSERT_EQ(Bignum(-15), m);
+}
+
+TEST(BignumTest, ReadingThresholds) {
+    BignumThresholds defaults;
+    BignumThresholds thresholds;
+    std::istringstream in("# tuned\n\nkaratsuba_digits 24\nbulk_shift_digits 2\n");
+
+    ASSERT_TRUE(read_bignum_thresholds(in, thresholds));
+    ASSERT_EQ(24U, thresholds.karatsuba_digits);
+    ASSERT_EQ(2U, thresholds.bulk_shift_digits);
+    ASSERT_EQ(defaults.block_add_digits, thresholds.block_add_digits);
+}
+
+TEST(BignumTest, ThresholdFilesWithBadSettingsAreIgnored) {
+    const char* files[] = {
+        "karatsuba_digits lots\n", "fft_digits 9000\n", "block_add_digits 3 4\n", "bulk_shift_digits -1\n",
+        "block_add_digits 3\nkaratsuba_digits 1\n", "karatsuba_digits 0\n", "karatsuba_digits\n"
+    };
+
+    for (unsigned int i = 0; i < sizeof(files) / sizeof(files[0]); ++i) {
+        BignumThresholds thresholds;
+        std::istringstream in(files[i]);
+
+        ASSERT_FALSE(read_bignum_thresholds(in, thresholds)) << files[i];
+        ASSERT_EQ(BignumThresholds().block_add_digits, thresholds.block_add_digits) << files[i];
+        ASSERT_EQ(BignumThresholds().bulk_shift_digits, thresholds.bulk_shift_digits) << files[i];
+        ASSERT_EQ(BignumThresholds().karatsuba_digits, thresholds.karatsuba_digits) << files[i];
+    }
+}
+
+TEST(BignumTest, MultiplyingAfterABadKaratsubaThreshold) {
+    const BignumThresholds saved = bignum_thresholds();
+    BignumThresholds thresholds;
+    std::istringstream in("karatsuba_digits 1\n");
+    ASSERT_FALSE(read_bignum_thresholds(in, thresholds));
+    set_bignum_thresholds(thresholds);
+
+    Bignum a = (Bignum(1) << 3000) - 1;
+    Bignum b = (Bignum(1) << 2000) + 12345;
+    Bignum expected = (Bignum(1) << 5000) + (Bignum(12345) << 3000) - (Bignum(1) << 2000) - 12345;
+    ASSERT_EQ(expected, a * b);
+
+    // Even set directly, a threshold too small to split on falls back to
+    // schoolbook multiplication.
+    thresholds.karatsuba_digits = 0;
+    set_bignum_thresholds(thresholds);
+    ASSERT_EQ(expected, a * b);
+    ASSERT_EQ(Bignum(6), Bignum(2) * Bignum(3));
+
+    set_bignum_thresholds(saved);
+}
+
+TEST(BignumTest, WrittenThresholdsReadBack) {
+    BignumThresholds written;
+    written.block_add_digits = 5;
+    written.bulk_shift_digits = 6;
+    written.karatsuba_digits = 7;
+    std::stringstream file;
+    write_bignum_thresholds(file, written);
+
+    BignumThresholds read;
+    ASSERT_TRUE(read_bignum_thresholds(file, read));
+    ASSERT_EQ(5U, read.block_add_digits);
+    ASSERT_EQ(6U, read.bulk_shift_digits);
+    ASSERT_EQ(7U, read.karatsuba_digits);
+}
+
+// A random value of the given width with every seventh digit zeroed, so
+// that the tiers also meet runs of zero digits.
+Bignum pseudo_random(RandomBignum& random, int num_digits) {
+    std::deque<uint32_t> digits;
+    for (int i = 0; i < num_digits; ++i)
+        digits.push_back((i % 7 == 3) ? 0U : (uint32_t) (random.next() >> 32));
+    if (digits.back() == 0U)
+        digits.back() = 1U;
+    return Bignum(digits, 1);
+}
+
+TEST(BignumTest, EveryTierAgreesWithTheSimplestOne) {
+    const BignumThresholds saved = bignum_thresholds();
+    BignumThresholds simplest;
+    simplest.block_add_digits = 1000000;
+    simplest.bulk_shift_digits = 1000000;
+    simplest.karatsuba_digits = 1000000;
+    BignumThresholds eager;
+    eager.block_add_digits = 0;
+    eager.bulk_shift_digits = 0;
+    eager.karatsuba_digits = 2;
+
+    RandomBignum random(271828);
+    const int sizes[] = { 1, 2, 3, 17, 64, 100, 257 };
+    const int count = sizeof(sizes) / sizeof(sizes[0]);
+    for (int i = 0; i < count; ++i) {
+        for (int j = 0; j < count; ++j) {
+            Bignum a = pseudo_random(random, sizes[i]);
+            Bignum b = -pseudo_random(random, sizes[j]);
+
+            set_bignum_thresholds(simplest);
+            Bignum sum = a + b;
+            Bignum difference = a - b;
+            Bignum product = a * b;
+            Bignum shifted = a << (unsigned int) (32 * sizes[j] + 5);
+
+            set_bignum_thresholds(eager);
+            EXPECT_EQ(sum, a + b) << sizes[i] << " " << sizes[j];
+            EXPECT_EQ(difference, a - b) << sizes[i] << " " << sizes[j];
+            EXPECT_EQ(product, a * b) << sizes[i] << " " << sizes[j];
+            EXPECT_EQ(shifted, a << (unsigned int) (32 * sizes[j] + 5)) << sizes[i] << " " << sizes[j];
+        }
+    }
+
+    set_bignum_thresholds(saved);
+}
+
+TEST(BignumTest, SettingAndClearingBitsOfNegativeValuesMatchesMasking) {
+    const Bignum values[] = {
+        Bignum(-1), Bignum(-6), Bignum(-(int64_t) 0x100000000LL), -(Bignum(1) << 96), -(Bignum(5) << 70),
+        -((Bignum(1) << 128) - 1), -(Bignum(0xFFFFFFFFLL) << 64)
+    };
+    const uint64_t bits[] = { 0, 1, 31, 32, 63, 64, 70, 95, 96, 100, 127, 128, 129, 200 };
+
+    for (unsigned int i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+        for (unsigned int j = 0; j < sizeof(bits) / sizeof(bits[0]); ++j) {
+            Bignum mask = Bignum(1) << (unsigned int) bits[j];
+
+            Bignum set = values[i];
+            set.set_bit(bits[j]);
+            ASSERT_EQ(values[i] | mask, set) << i << " " << bits[j];
+            ASSERT_TRUE(set.test_bit(bits[j]));
+
+            Bignum cleared = values[i];
+            cleared.clear_bit(bits[j]);
+            ASSERT_EQ(values[i] & ~mask, cleared) << i << " " << bits[j];
+            ASSERT_FALSE(cleared.test_bit(bits[j]));
+        }
+    }
+}
+
+// Each step leaves the value negative, with its lowest non-zero digit
+// moved, so test_bit sees every way a mutation can shift it.
+TEST(BignumTest, TestingBitsOfNegativeValuesAfterEveryKindOfUpdate) {
+    Bignum n = -(Bignum(1) << 300);
+    for (int step = 0; step < 12; ++step) {
+        switch (step) {
+            case 0: n += 1; break;
+            case 1: n -= Bignum(1) << 64; break;
+            case 2: n <<= 40; break;
+            case 3: n >>= 100; break;
+            case 4: n *= 3; break;
+            case 5: n -= Bignum(-5) << 64; break;
+            case 6: n.set_bit(1); break;
+            case 7: n.clear_bit(40); break;
+            case 8: n *= Bignum(1) << 64; break;
+            case 9: n.set_bit(64); break;
+            case 10: n.clear_bit(300); break;
+            case 11: n = -n - (Bignum(7) << 200); break;
+        }
+
+        for (unsigned int bit = 0; bit < 400; ++bit)
+            ASSERT_EQ((n & (Bignum(1) << bit)).signum() != 0, n.test_bit(bit)) << step << " " << bit;
+    }
+}
+
+TEST(BignumTest, BitLoopsOverLongRunsOfLowZeros) {
+    const unsigned int zeros = 1 << 18;
+    Bignum n = -(Bignum(1) << zeros);
+
+    unsigned int set = 0;
+    for (unsigned int bit = 0; bit < zeros + 10; ++bit)
+        set += n.test_bit(bit);
+    ASSERT_EQ(10U, set);
+
+    for (unsigned int bit = 0; bit < zeros; bit += 2)
+        n.set_bit(bit);
+    ASSERT_EQ(((Bignum(1) << zeros) - 1) / 3 - (Bignum(1) << zeros), n);
+}
+
+TEST(BignumTest, BitIndicesBeyondThirtyTwoBits) {
+    const uint64_t far = (1ULL << 32) + 1;
+    Bignum n(-4);
+
+    ASSERT_TRUE(n.test_bit(far));
+    n.set_bit(far);
+    ASSERT_EQ(Bignum(-4), n);
+
+    Bignum m(4);
+    ASSERT_FALSE(m.test_bit(far));
+    m.clear_bit(far);
+    ASSERT_EQ(Bignum(4), m);
+}
@@ -0,0 +1,197 @@
+#include "BinarySplitting.h"
+#include "Parallel.h"
+#include <cmath>
+#include <sstream>
+
+const uint64_t BinarySplitter::PARALLEL_THRESHOLD = 64;
+const double ChudnovskySeries::DIGITS_PER_TERM = 14.181647462725477;
+
+const unsigned int GUARD_DIGITS = 8;
+
+HypergeometricSeries::~HypergeometricSeries() {
+}
+
+SplitSum::SplitSum() : p(1), q(1), t(0) {
+}
+
+// Joins adjacent ranges:  P = Pl Pr,  Q = Ql Qr,  T = Tl Qr + Pl Tr.
+// Each half's numbers are dropped as soon as they have been used, so no
+// more than one level of partial products is alive at a time.
+void join(SplitSum& left, SplitSum& right, const bool need_p, SplitSum& joined) {
+    joined.t = left.t * right.q;
+    left.t = 0;
+    joined.t += left.p * right.t;
+    right.t = 0;
+
+    joined.q = left.q * right.q;
+    left.q = 0;
+    right.q = 0;
+
+    if (need_p)
+        joined.p = left.p * right.p;
+    else
+        joined.p = 1;
+    left.p = 0;
+    right.p = 0;
+}
+
+class SplitTask : public ParallelTask {
+    public:
+        SplitTask(const BinarySplitter& splitter, const uint64_t begin, const uint64_t middle, const uint64_t end,
+            const bool need_p, const unsigned int threads)
+            : splitter(splitter), begin(begin), middle(middle), end(end), need_p(need_p), threads(threads) {
+        }
+
+        void run(std::size_t first, std::size_t last) {
+            for (std::size_t half = first; half < last; ++half) {
+                if (half == 0)
+                    left = splitter.sum(begin, middle, true, (threads + 1) / 2);
+                else
+                    right = splitter.sum(middle, end, need_p, threads / 2);
+            }
+        }
+
+        SplitSum left;
+        SplitSum right;
+
+    private:
+        const BinarySplitter& splitter;
+        uint64_t begin;
+        uint64_t middle;
+        uint64_t end;
+        bool need_p;
+        unsigned int threads;
+};
+
+BinarySplitter::BinarySplitter(const HypergeometricSeries& series, const unsigned int threads)
+    : series(series), threads(threads) {
+}
+
+SplitSum BinarySplitter::sum(const uint64_t begin, const uint64_t end, const bool need_p) const {
+    return sum(begin, end, need_p, threads);
+}
+
+SplitSum BinarySplitter::sum(const uint64_t begin, const uint64_t end, const bool need_p,
+    const unsigned int thread_count) const {
+    SplitSum result;
+    if (end <= begin)
+        return result;
+
+    if (end - begin == 1) {
+        result.p = series.p(begin);
+        result.q = series.q(begin);
+        result.t = series.a(begin) * result.p;
+        if (!need_p)
+            result.p = 1;
+        return result;
+    }
+
+    const uint64_t middle = begin + (end - begin) / 2;
+    if (thread_count > 1 && end - begin >= PARALLEL_THRESHOLD) {
+        SplitTask task(*this, begin, middle, end, need_p, thread_count);
+        parallel_for(task, 2, 2);
+        join(task.left, task.right, need_p, result);
+    } else {
+        SplitSum left = sum(begin, middle, true, 1);
+        SplitSum right = sum(middle, end, need_p, 1);
+        join(left, right, need_p, result);
+    }
+
+    return result;
+}
+
+// 13591409 + 545140134 k
+Bignum ChudnovskySeries::a(const uint64_t k) const {
+    return Bignum(545140134) * (int64_t) k + 13591409;
+}
+
+// -(6k - 5)(2k - 1)(6k - 1)
+Bignum ChudnovskySeries::p(const uint64_t k) const {
+    if (k == 0)
+        return Bignum(1);
+
+    return -(Bignum((int64_t) (6 * k - 5)) * (int64_t) (2 * k - 1) * (int64_t) (6 * k - 1));
+}
+
+// k^3 640320^3 / 24
+Bignum ChudnovskySeries::q(const uint64_t k) const {
+    if (k == 0)
+        return Bignum(1);
+
+    return Bignum((int64_t) k) * (int64_t) k * (int64_t) k * (int64_t) 10939058860032000LL;
+}
+
+Bignum ExponentialSeries::a(uint64_t) const {
+    return Bignum(1);
+}
+
+Bignum ExponentialSeries::p(uint64_t) const {
+    return Bignum(1);
+}
+
+Bignum ExponentialSeries::q(const uint64_t k) const {
+    return Bignum(k == 0 ? 1 : (int64_t) k);
+}
+
+// floor(2^bits / sqrt(value)), give or take a few units in the last place,
+// by Newton's iteration  y <- y (3 - value y^2) / 2  for the reciprocal
+// square root.  Unlike Newton's iteration for the square root itself it
+// needs no division, only shifts, and since each step doubles the correct
+// bits it is run at double the previous step's precision: the whole costs
+// about two full-precision multiplications.
+Bignum reciprocal_square_root(const uint32_t value, const unsigned int bits) {
+    if (bits <= 48)
+        return Bignum((int64_t) std::ldexp(1 / std::sqrt((double) value), bits));
+
+    const unsigned int half = bits / 2 + 16;
+    Bignum root = reciprocal_square_root(value, half) << (bits - half);
+
+    Bignum correction = (Bignum(3) << (2 * bits)) - root * root * (int64_t) value;
+    return (root * correction) >> (2 * bits + 1);
+}
+
+// pi = 426880 sqrt(10005) Q / T = 426880 * 10005 Q / (sqrt(10005) T).  The
+// reciprocal square root comes from a division-free iteration, so the
+// series is finished with one multiplication by it and a single division
+// by T; the guard digits are only there to absorb the truncated series and
+// the root's last bits, and are never divided out.
+Bignum pi_digits(const uint64_t digits, const unsigned int threads) {
+    const uint64_t precision = digits + GUARD_DIGITS;
+    const uint64_t terms = (uint64_t) (precision / ChudnovskySeries::DIGITS_PER_TERM) + 2;
+
+    ChudnovskySeries series;
+    SplitSum sum = BinarySplitter(series, threads).sum(0, terms, false);
+
+    const unsigned int bits = (unsigned int) (precision * 3.3219280948873623) + 32;
+    Bignum numerator = reciprocal_square_root(10005, bits) * (int64_t) 4270934400LL;  // 426880 * 10005
+    numerator *= sum.q;
+    numerator *= power_of(Bignum(10), digits);
+
+    return (numerator >> bits) / sum.t;
+}
+
+// e = T / Q, summed until k! passes 10^precision.
+Bignum e_digits(const uint64_t digits, const unsigned int threads) {
+    const uint64_t precision = digits + GUARD_DIGITS;
+    uint64_t terms = 1;
+    for (double size = 0; size <= precision; ++terms)
+        size += std::log10((double) terms);
+
+    ExponentialSeries series;
+    SplitSum sum = BinarySplitter(series, threads).sum(0, terms + 1, false);
+
+    return sum.t * power_of(Bignum(10), digits) / sum.q;
+}
+
+std::string decimal_expansion(const Bignum& scaled, const uint64_t digits) {
+    std::ostringstream out;
+    out << scaled;
+
+    std::string expansion = out.str();
+    if (expansion.size() <= digits)
+        expansion.insert(0, digits + 1 - expansion.size(), '0');
+    if (digits > 0)
+        expansion.insert(expansion.size() - digits, 1, '.');
+
+    return expansion;
+}
@@ -0,0 +1,74 @@
+#ifndef PHOLSER_BINARY_SPLITTING_H
+#define PHOLSER_BINARY_SPLITTING_H
+
+#include "Bignum.h"
+#include <tr1/cstdint>
+#include <string>
+
+// A hypergeometric series
+//
+//     sum over k of a(k) * p(0) ... p(k) / (q(0) ... q(k))
+//
+// in which consecutive terms have a ratio of small integer polynomials.
+class HypergeometricSeries {
+    public:
+        virtual ~HypergeometricSeries();
+        virtual Bignum a(uint64_t) const = 0;
+        virtual Bignum p(uint64_t) const = 0;
+        virtual Bignum q(uint64_t) const = 0;
+};
+
+// Over the terms [begin, end): P and Q are the products of p(k) and q(k),
+// and T / Q is the sum of those terms with the products restarted at
+// begin.
+struct SplitSum {
+    SplitSum();
+
+    Bignum p;
+    Bignum q;
+    Bignum t;
+};
+
+// Evaluates the terms [begin, end) by splitting the range in halves and
+// combining exact integer triples, running halves on separate threads
+// while threads remain.  P is left at 1 when need_p is false; the right
+// spine of the tree never needs it.
+class BinarySplitter {
+    public:
+        static const uint64_t PARALLEL_THRESHOLD;
+
+        BinarySplitter(const HypergeometricSeries&, unsigned int);
+
+        SplitSum sum(uint64_t, uint64_t, bool) const;
+        SplitSum sum(uint64_t, uint64_t, bool, unsigned int) const;
+
+    private:
+        const HypergeometricSeries& series;
+        unsigned int threads;
+};
+
+class ChudnovskySeries : public HypergeometricSeries {
+    public:
+        static const double DIGITS_PER_TERM;
+
+        Bignum a(uint64_t) const;
+        Bignum p(uint64_t) const;
+        Bignum q(uint64_t) const;
+};
+
+class ExponentialSeries : public HypergeometricSeries {
+    public:
+        Bignum a(uint64_t) const;
+        Bignum p(uint64_t) const;
+        Bignum q(uint64_t) const;
+};
+
+// floor(pi * 10^digits) and floor(e * 10^digits), each finished with a
+// single division of the summed series.
+Bignum pi_digits(uint64_t, unsigned int);
+Bignum e_digits(uint64_t, unsigned int);
+
+// The decimal expansion of scaled / 10^digits, for non-negative scaled.
+std::string decimal_expansion(const Bignum&, uint64_t);
+
+#endif  // PHOLSER_BINARY_SPLITTING_H
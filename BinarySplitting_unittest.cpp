@@ -0,0 +1,87 @@
+#include "BinarySplitting.h"
+#include "gtest/gtest.h"
+#include <string>
+
+const std::string PI_100 =
+    "3.1415926535897932384626433832795028841971693993751058209749445923078164062862089986280348253421170679";
+const std::string E_100 =
+    "2.7182818284590452353602874713526624977572470936999595749669676277240766303535475945713821785251664274";
+
+// sum of 1 / 2^(k + 1) over k below n, which is 1 - 1 / 2^n
+class HalvingSeries : public HypergeometricSeries {
+    public:
+        Bignum a(uint64_t) const {
+            return Bignum(1);
+        }
+
+        Bignum p(uint64_t) const {
+            return Bignum(1);
+        }
+
+        Bignum q(uint64_t) const {
+            return Bignum(2);
+        }
+};
+
+TEST(BinarySplittingTest, SplitSumsAreExact) {
+    HalvingSeries series;
+    SplitSum sum = BinarySplitter(series, 1).sum(0, 100, true);
+
+    ASSERT_EQ(Bignum(1), sum.p);
+    ASSERT_EQ(Bignum(1) << 100, sum.q);
+    ASSERT_EQ((Bignum(1) << 100) - 1, sum.t);
+}
+
+TEST(BinarySplittingTest, EmptyRange) {
+    HalvingSeries series;
+    SplitSum sum = BinarySplitter(series, 4).sum(7, 7, true);
+
+    ASSERT_EQ(Bignum(1), sum.p);
+    ASSERT_EQ(Bignum(1), sum.q);
+    ASSERT_EQ(Bignum(0), sum.t);
+}
+
+TEST(BinarySplittingTest, ProductOfPIsOnlyKeptWhenAskedFor) {
+    ChudnovskySeries series;
+    BinarySplitter splitter(series, 1);
+    SplitSum with_p = splitter.sum(0, 20, true);
+    SplitSum without_p = splitter.sum(0, 20, false);
+
+    ASSERT_EQ(Bignum(1), without_p.p);
+    ASSERT_NE(Bignum(1), with_p.p);
+    ASSERT_EQ(with_p.q, without_p.q);
+    ASSERT_EQ(with_p.t, without_p.t);
+}
+
+TEST(BinarySplittingTest, ParallelSplittingMatchesSequential) {
+    ChudnovskySeries series;
+    SplitSum sequential = BinarySplitter(series, 1).sum(0, 500, true);
+    SplitSum parallel = BinarySplitter(series, 8).sum(0, 500, true);
+
+    ASSERT_EQ(sequential.p, parallel.p);
+    ASSERT_EQ(sequential.q, parallel.q);
+    ASSERT_EQ(sequential.t, parallel.t);
+}
+
+TEST(BinarySplittingTest, HundredDigitsOfPi) {
+    ASSERT_EQ(PI_100, decimal_expansion(pi_digits(100, 1), 100));
+    ASSERT_EQ("3", decimal_expansion(pi_digits(0, 1), 0));
+    ASSERT_EQ("3.14", decimal_expansion(pi_digits(2, 1), 2));
+}
+
+TEST(BinarySplittingTest, HundredDigitsOfE) {
+    ASSERT_EQ(E_100, decimal_expansion(e_digits(100, 1), 100));
+}
+
+TEST(BinarySplittingTest, LongerExpansionsAgreeAcrossThreadCounts) {
+    Bignum pi = pi_digits(5000, 8);
+
+    ASSERT_EQ(pi_digits(5000, 1), pi);
+    ASSERT_EQ(PI_100, decimal_expansion(pi, 5000).substr(0, 102));
+    ASSERT_EQ(E_100, decimal_expansion(e_digits(5000, 4), 5000).substr(0, 102));
+}
+
+TEST(BinarySplittingTest, DecimalExpansionPadsSmallValues) {
+    ASSERT_EQ("0.05", decimal_expansion(Bignum(5), 2));
+    ASSERT_EQ("12.345", decimal_expansion(Bignum(12345), 3));
+}
@@ -0,0 +1,58 @@
+#include "Parallel.h"
+#include <algorithm>
+#include <vector>
+#include <pthread.h>
+#include <unistd.h>
+
+struct ParallelSlice {
+    ParallelTask* task;
+    std::size_t begin;
+    std::size_t end;
+};
+
+void* run_parallel_slice(void* argument) {
+    ParallelSlice* slice = static_cast<ParallelSlice*>(argument);
+    slice->task->run(slice->begin, slice->end);
+    return 0;
+}
+
+ParallelTask::~ParallelTask() {
+}
+
+unsigned int hardware_threads() {
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    return processors > 0 ? processors : 1;
+}
+
+// Splits [0, count) into at most the given number of contiguous slices and
+// runs them on their own threads, the first slice on the calling thread.
+void parallel_for(ParallelTask& task, const std::size_t count, const unsigned int threads) {
+    std::size_t slices = std::min<std::size_t>(std::max(threads, 1U), count);
+    if (slices <= 1) {
+        if (count > 0)
+            task.run(0, count);
+        return;
+    }
+
+    std::vector<ParallelSlice> work(slices);
+    for (std::size_t i = 0; i < slices; ++i) {
+        work[i].task = &task;
+        work[i].begin = count * i / slices;
+        work[i].end = count * (i + 1) / slices;
+    }
+
+    std::vector<pthread_t> workers(slices);
+    std::size_t started = 1;
+    for (; started < slices; ++started) {
+        if (pthread_create(&workers[started], 0, run_parallel_slice, &work[started]) != 0)
+            break;
+    }
+
+    // Whatever could not get a thread of its own runs here.
+    run_parallel_slice(&work[0]);
+    for (std::size_t i = started; i < slices; ++i)
+        run_parallel_slice(&work[i]);
+
+    for (std::size_t i = 1; i < started; ++i)
+        pthread_join(workers[i], 0);
+}
@@ -0,0 +1,17 @@
+#ifndef PHOLSER_PARALLEL_H
+#define PHOLSER_PARALLEL_H
+
+#include <cstddef>
+
+// A unit of work over an index range that can be split across threads.
+// run() is called concurrently on disjoint ranges and must not throw.
+class ParallelTask {
+    public:
+        virtual ~ParallelTask();
+        virtual void run(std::size_t, std::size_t) = 0;
+};
+
+unsigned int hardware_threads();
+void parallel_for(ParallelTask&, std::size_t, unsigned int);
+
+#endif  // PHOLSER_PARALLEL_H
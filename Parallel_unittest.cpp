@@ -0,0 +1,41 @@
+#include "Parallel.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+class MarkingTask : public ParallelTask {
+    public:
+        MarkingTask(std::size_t count) : marks(count, 0) {
+        }
+
+        void run(std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i)
+                ++marks[i];
+        }
+
+        std::vector<int> marks;
+};
+
+TEST(ParallelTest, HardwareThreadsIsPositive) {
+    ASSERT_LT(0U, hardware_threads());
+}
+
+TEST(ParallelTest, EveryIndexIsVisitedExactlyOnce) {
+    MarkingTask task(1001);
+    parallel_for(task, task.marks.size(), 7);
+
+    ASSERT_EQ(std::vector<int>(1001, 1), task.marks);
+}
+
+TEST(ParallelTest, MoreThreadsThanWork) {
+    MarkingTask task(3);
+    parallel_for(task, task.marks.size(), 16);
+
+    ASSERT_EQ(std::vector<int>(3, 1), task.marks);
+}
+
+TEST(ParallelTest, NoWork) {
+    MarkingTask task(0);
+    parallel_for(task, 0, 4);
+
+    ASSERT_TRUE(task.marks.empty());
+}
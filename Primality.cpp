@@ -0,0 +1,438 @@
+#include "Primality.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+
+const uint32_t SMALL_PRIME_LIMIT = 1 << 16;
+const uint32_t TRIAL_DIVISION_LIMIT = 1 << 12;
+
+std::vector<uint32_t> sieve_small_primes() {
+    std::vector<uint32_t> primes;
+    std::vector<bool> composite(SMALL_PRIME_LIMIT, false);
+    for (uint32_t i = 2; i < SMALL_PRIME_LIMIT; ++i) {
+        if (composite[i])
+            continue;
+
+        primes.push_back(i);
+        for (uint32_t j = i * i; j < SMALL_PRIME_LIMIT; j += i)
+            composite[j] = true;
+    }
+
+    return primes;
+}
+
+// Bound once, by the static's own initialization, which is safe against
+// concurrent first calls; the table is never written after that.
+const std::vector<uint32_t>& small_primes() {
+    static const std::vector<uint32_t> primes = sieve_small_primes();
+    return primes;
+}
+
+Primality trial_division(const Bignum& n, const uint32_t limit) {
+    if (n < 2)
+        return COMPOSITE;
+
+    const std::vector<uint32_t>& primes = small_primes();
+    std::vector<uint32_t>::size_type i = 0;
+    while (i < primes.size() && primes[i] <= limit) {
+        // Pack as many primes as fit into one word, so that a single pass
+        // over the digits of n serves all of them.
+        uint64_t product = primes[i];
+        std::vector<uint32_t>::size_type end = i + 1;
+        for (; end < primes.size() && primes[end] <= limit && product * primes[end] <= UINT32_MAX; ++end)
+            product *= primes[end];
+
+        const uint32_t remainder = n.remainder((uint32_t) product);
+        for (; i < end; ++i) {
+            if (remainder % primes[i] == 0)
+                return n == (uint64_t) primes[i] ? PRIME : COMPOSITE;
+            if (n < (uint64_t) primes[i] * primes[i])
+                return PRIME;
+        }
+    }
+
+    // Every composite below 2^32 has a factor in the table.
+    if (i == primes.size() && n <= (uint64_t) UINT32_MAX)
+        return PRIME;
+
+    return PROBABLE_PRIME;
+}
+
+// The least non-negative residue of n modulo m.
+Bignum residue_of(const Bignum& n, const Bignum& m) {
+    Bignum r = n % m;
+    if (r.signum() < 0)
+        r += m;
+
+    return r;
+}
+
+Bignum modular_power(const Bignum& base, const Bignum& exponent, const Bignum& modulus) {
+    if (exponent.signum() == 0)
+        return residue_of(Bignum(1), modulus);
+
+    const Bignum b = residue_of(base, modulus);
+    Bignum result = b;
+    for (uint64_t bit = exponent.bit_length() - 1; bit-- > 0;) {
+        result = result * result % modulus;
+        if (exponent.test_bit(bit))
+            result = result * b % modulus;
+    }
+
+    return result;
+}
+
+bool is_square(const Bignum& n) {
+    // Most non-squares are already non-residues modulo 64, 63, 65 or 11.
+    const uint32_t r = n.remainder(64 * 63 * 65 * 11);
+    const uint32_t moduli[] = { 64, 63, 65, 11 };
+    for (unsigned int i = 0; i < sizeof(moduli) / sizeof(moduli[0]); ++i) {
+        bool residue = false;
+        for (uint32_t x = 0; x < moduli[i] && !residue; ++x)
+            residue = x * x % moduli[i] == r % moduli[i];
+        if (!residue)
+            return false;
+    }
+
+    const Bignum root = integer_square_root(n);
+    return root * root == n;
+}
+
+int word_jacobi(uint64_t a, uint64_t n) {
+    int result = 1;
+
+    for (a %= n; a != 0; a %= n) {
+        for (; a % 2 == 0; a /= 2) {
+            if (n % 8 == 3 || n % 8 == 5)
+                result = -result;
+        }
+        std::swap(a, n);
+        if (a % 4 == 3 && n % 4 == 3)
+            result = -result;
+    }
+
+    return n == 1 ? result : 0;
+}
+
+// The Jacobi symbol (a / n) for odd positive n and |a| below 2^32.
+int jacobi_symbol(const int64_t a, const Bignum& n) {
+    int result = 1;
+    uint64_t top = a < 0 ? -(uint64_t) a : (uint64_t) a;
+    if (a < 0 && n.remainder(4) == 3)
+        result = -result;
+
+    if (top == 0)
+        return n == 1 ? 1 : 0;
+
+    for (; top % 2 == 0; top /= 2) {
+        const uint32_t r = n.remainder(8);
+        if (r == 3 || r == 5)
+            result = -result;
+    }
+
+    if (top % 4 == 3 && n.remainder(4) == 3)
+        result = -result;
+
+    return top == 1 ? result : result * word_jacobi(n.remainder((uint32_t) top), top);
+}
+
+unsigned int strip_twos(Bignum& n) {
+    unsigned int twos = 0;
+    for (; n.signum() != 0 && !n.test_bit(0); ++twos)
+        n >>= 1;
+
+    return twos;
+}
+
+bool is_strong_probable_prime(const Bignum& n, const Bignum& base) {
+    if (n < 2)
+        return false;
+    if (!n.test_bit(0))
+        return n == 2;
+
+    const Bignum minus_one = n - 1;
+    Bignum odd = minus_one;
+    const unsigned int twos = strip_twos(odd);
+
+    const Bignum b = residue_of(base, n);
+    if (b.signum() == 0)
+        return true;
+
+    Bignum x = modular_power(b, odd, n);
+    if (x == 1 || x == minus_one)
+        return true;
+
+    for (unsigned int i = 1; i < twos; ++i) {
+        x = x * x % n;
+        if (x == minus_one)
+            return true;
+        if (x == 1)
+            return false;
+    }
+
+    return false;
+}
+
+// x / 2 modulo odd n, for 0 <= x < n.
+Bignum halve(Bignum x, const Bignum& n) {
+    if (x.test_bit(0))
+        x += n;
+
+    return x >>= 1;
+}
+
+bool is_strong_lucas_probable_prime(const Bignum& n) {
+    if (n < 2)
+        return false;
+    if (!n.test_bit(0))
+        return n == 2;
+    if (is_square(n))
+        return false;
+
+    // Selfridge's method A: the first of 5, -7, 9, -11, ... with Jacobi
+    // symbol -1, and then P = 1, Q = (1 - D) / 4.
+    int64_t d = 5;
+    for (;; d = d > 0 ? -(d + 2) : -d + 2) {
+        const int symbol = jacobi_symbol(d, n);
+        if (symbol == -1)
+            break;
+        if (symbol == 0)
+            return n == (uint64_t) (d < 0 ? -d : d);
+    }
+
+    const Bignum discriminant = residue_of(Bignum(d), n);
+    const Bignum q = residue_of(Bignum((1 - d) / 4), n);
+
+    Bignum odd = n + 1;
+    const unsigned int twos = strip_twos(odd);
+
+    // U, V and Q^k for k running through the leading bits of the odd part.
+    Bignum u(1);
+    Bignum v(1);
+    Bignum q_power = q;
+    for (uint64_t bit = odd.bit_length() - 1; bit-- > 0;) {
+        u = u * v % n;
+        v = residue_of(v * v - q_power * 2, n);
+        q_power = q_power * q_power % n;
+
+        if (odd.test_bit(bit)) {
+            Bignum next_u = halve((u + v) % n, n);
+            v = halve((discriminant * u + v) % n, n);
+            u = next_u;
+            q_power = q_power * q % n;
+        }
+    }
+
+    if (u == 0 || v == 0)
+        return true;
+
+    for (unsigned int i = 1; i < twos; ++i) {
+        v = residue_of(v * v - q_power * 2, n);
+        if (v == 0)
+            return true;
+        q_power = q_power * q_power % n;
+    }
+
+    return false;
+}
+
+Primality baillie_psw(const Bignum& n) {
+    const Primality divided = trial_division(n, n.bit_length() <= 32 ? SMALL_PRIME_LIMIT : TRIAL_DIVISION_LIMIT);
+    if (divided != PROBABLE_PRIME)
+        return divided;
+
+    if (!is_strong_probable_prime(n, Bignum(2)) || !is_strong_lucas_probable_prime(n))
+        return COMPOSITE;
+
+    return PROBABLE_PRIME;
+}
+
+Bignum from_word(const uint64_t value) {
+    Bignum n(0);
+    return n += value;
+}
+
+// A modulus of the form k * 2^n + c, c = 1 or -1.  Since k * 2^n is
+// congruent to -c, a value q * 2^n + r with q = q1 * k + q0 is congruent
+// to q0 * 2^n + r - c * q1: the high part is folded down with shifts and
+// a division by the single word k, never by the modulus itself.
+class SpecialFormModulus {
+    public:
+        SpecialFormModulus(const uint64_t multiplier, const uint64_t exponent, const int offset)
+            : multiplier(multiplier), exponent(exponent), offset(offset),
+              modulus((from_word(multiplier) << (unsigned int) exponent) + offset),
+              fold_above(exponent + from_word(multiplier).bit_length()) {
+        }
+
+        const Bignum& value() const {
+            return modulus;
+        }
+
+        Bignum reduce(const Bignum& n) const {
+            int sign = n.signum();
+            Bignum rest = n.abs();
+
+            while (rest.bit_length() > fold_above) {
+                Bignum high = rest >> (unsigned int) exponent;
+                Bignum low = rest - (high << (unsigned int) exponent);
+                Bignum quotient = high / multiplier;
+                Bignum leftover = high - quotient * multiplier;
+
+                rest = (leftover << (unsigned int) exponent) + low;
+                if (offset > 0)
+                    rest -= quotient;
+                else
+                    rest += quotient;
+
+                if (rest.signum() < 0) {
+                    rest = -rest;
+                    sign = -sign;
+                }
+            }
+
+            Bignum result = sign < 0 ? -rest : rest;
+            while (result.signum() < 0)
+                result += modulus;
+            while (result >= modulus)
+                result -= modulus;
+
+            return result;
+        }
+
+    private:
+        uint64_t multiplier;
+        uint64_t exponent;
+        int offset;
+        Bignum modulus;
+        uint64_t fold_above;
+};
+
+Bignum special_form_power(const SpecialFormModulus& modulus, const Bignum& base, const uint64_t exponent) {
+    Bignum result(1);
+    for (int bit = 63; bit >= 0; --bit) {
+        result = modulus.reduce(result * result);
+        if (exponent >> bit & 1)
+            result = modulus.reduce(result * base);
+    }
+
+    return result;
+}
+
+// V_k(P, 1) by the Lucas ladder, keeping V_m and V_(m+1).
+Bignum lucas_v(const SpecialFormModulus& modulus, const uint64_t p, const uint64_t k) {
+    Bignum low(2);
+    Bignum high = from_word(p);
+    for (int bit = 63; bit >= 0; --bit) {
+        if (k >> bit & 1) {
+            low = modulus.reduce(low * high - p);
+            high = modulus.reduce(high * high - 2);
+        } else {
+            high = modulus.reduce(low * high - p);
+            low = modulus.reduce(low * low - 2);
+        }
+    }
+
+    return low;
+}
+
+void check_special_form(const uint64_t k, const uint64_t n) {
+    if (k % 2 == 0)
+        throw std::invalid_argument("multiplier must be odd");
+    if (n == 0 || n > UINT_MAX || (n < 64 && k >> n != 0))
+        throw std::invalid_argument("multiplier must be less than 2^n");
+}
+
+// Proth's theorem: N = k * 2^n + 1 is prime iff a^((N - 1) / 2) = -1
+// for any quadratic non-residue a.
+bool proth_test(const uint64_t k, const uint64_t n) {
+    check_special_form(k, n);
+
+    const SpecialFormModulus modulus(k, n, 1);
+    const Bignum& value = modulus.value();
+    if (value.bit_length() <= 32)
+        return baillie_psw(value) == PRIME;
+    if (is_square(value))
+        return false;
+
+    const std::vector<uint32_t>& primes = small_primes();
+    for (std::vector<uint32_t>::size_type i = 0; i < primes.size(); ++i) {
+        const int symbol = jacobi_symbol(primes[i], value);
+        if (symbol == 0)
+            return false;
+        if (symbol == 1)
+            continue;
+
+        Bignum x = special_form_power(modulus, Bignum(primes[i]), k);
+        for (uint64_t j = 1; j < n; ++j)
+            x = modulus.reduce(x * x);
+
+        return x == value - 1;
+    }
+
+    throw std::domain_error("no quadratic non-residue among the small primes");
+}
+
+// Pepin's test of the Fermat number 2^(2^m) + 1 is Proth's with k = 1,
+// where 3 is always a non-residue.
+bool pepin_test(const unsigned int m) {
+    if (m >= 32)
+        throw std::invalid_argument("Fermat number too large");
+
+    return m == 0 || proth_test(1, (uint64_t) 1 << m);
+}
+
+// Rodseth's form of the Lucas-Lehmer-Riesel test: with P such that
+// (P - 2 / N) = 1 and (P + 2 / N) = -1, N = k * 2^n - 1 is prime iff
+// u(n - 2) = 0, where u(0) = V_k(P, 1) and u(i + 1) = u(i)^2 - 2.
+bool lucas_lehmer_riesel_test(const uint64_t k, const uint64_t n) {
+    check_special_form(k, n);
+
+    const SpecialFormModulus modulus(k, n, -1);
+    const Bignum& value = modulus.value();
+    if (value.bit_length() <= 32)
+        return baillie_psw(value) == PRIME;
+
+    uint64_t p = 3;
+    for (;; ++p) {
+        const int below = jacobi_symbol(p - 2, value);
+        const int above = jacobi_symbol(p + 2, value);
+        if (below == 0 || above == 0)
+            return false;
+        if (below == 1 && above == -1)
+            break;
+    }
+
+    Bignum u = lucas_v(modulus, p, k);
+    for (uint64_t i = 2; i < n; ++i)
+        u = modulus.reduce(u * u - 2);
+
+    return u == 0;
+}
+
+class ScreenTask : public ParallelTask {
+    public:
+        ScreenTask(const std::vector<Bignum>& candidates, std::vector<Primality>& results)
+            : candidates(candidates), results(results) {
+        }
+
+        void run(std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i)
+                results[i] = baillie_psw(candidates[i]);
+        }
+
+    private:
+        const std::vector<Bignum>& candidates;
+        std::vector<Primality>& results;
+};
+
+std::vector<Primality> screen(const std::vector<Bignum>& candidates, const unsigned int threads) {
+    // Build the table before any thread needs it.
+    small_primes();
+
+    std::vector<Primality> results(candidates.size(), COMPOSITE);
+    ScreenTask task(candidates, results);
+    parallel_for(task, candidates.size(), std::max(threads, 1U));
+
+    return results;
+}
@@ -0,0 +1,37 @@
+#ifndef PHOLSER_PRIMALITY_H
+#define PHOLSER_PRIMALITY_H
+
+#include "Bignum.h"
+#include <tr1/cstdint>
+#include <vector>
+
+enum Primality { COMPOSITE, PROBABLE_PRIME, PRIME };
+
+// Primes below SMALL_PRIME_LIMIT, in increasing order.
+const std::vector<uint32_t>& small_primes();
+extern const uint32_t SMALL_PRIME_LIMIT;
+extern const uint32_t TRIAL_DIVISION_LIMIT;
+
+// Trial division by the small primes up to the given limit.  PRIME only
+// when the limit passes the square root of n; otherwise n is either shown
+// COMPOSITE or left a PROBABLE_PRIME for the tests below.
+Primality trial_division(const Bignum&, uint32_t);
+
+bool is_strong_probable_prime(const Bignum&, const Bignum&);
+bool is_strong_lucas_probable_prime(const Bignum&);
+
+// Baillie-PSW: trial division, a strong base-2 Miller-Rabin test and a
+// strong Lucas test with Selfridge's parameters.  No composite is known
+// to pass, but a pass is still only a PROBABLE_PRIME.
+Primality baillie_psw(const Bignum&);
+
+// Proofs for the special forms k * 2^n + 1 and k * 2^n - 1, odd k < 2^n.
+// Every reduction modulo these folds with shifts instead of dividing.
+bool proth_test(uint64_t, uint64_t);
+bool pepin_test(unsigned int);
+bool lucas_lehmer_riesel_test(uint64_t, uint64_t);
+
+// Runs baillie_psw() over the candidates, spread across threads.
+std::vector<Primality> screen(const std::vector<Bignum>&, unsigned int);
+
+#endif  // PHOLSER_PRIMALITY_H
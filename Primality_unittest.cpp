@@ -0,0 +1,114 @@
+#include "Primality.h"
+#include "gtest/gtest.h"
+#include <stdexcept>
+#include <vector>
+
+Bignum mersenne(unsigned int p) {
+    return (Bignum(1) << p) - 1;
+}
+
+TEST(PrimalityTest, SmallPrimeTable) {
+    const std::vector<uint32_t>& primes = small_primes();
+
+    ASSERT_EQ(6542U, primes.size());
+    ASSERT_EQ(2U, primes.front());
+    ASSERT_EQ(65521U, primes.back());
+}
+
+TEST(PrimalityTest, TrialDivisionSettlesWordSizedValues) {
+    ASSERT_EQ(COMPOSITE, baillie_psw(Bignum(0)));
+    ASSERT_EQ(COMPOSITE, baillie_psw(Bignum(1)));
+    ASSERT_EQ(COMPOSITE, baillie_psw(Bignum(-7)));
+    ASSERT_EQ(PRIME, baillie_psw(Bignum(2)));
+    ASSERT_EQ(PRIME, baillie_psw(Bignum(65521)));
+    ASSERT_EQ(COMPOSITE, baillie_psw(Bignum(65521) * 65521));
+    ASSERT_EQ(PRIME, baillie_psw(Bignum(4294967291LL)));
+    ASSERT_EQ(COMPOSITE, baillie_psw(Bignum(4294967297LL)));
+}
+
+TEST(PrimalityTest, TrialDivisionBelowTheSquareRootIsInconclusive) {
+    ASSERT_EQ(PROBABLE_PRIME, trial_division(Bignum(1000003) * 1000033, 1000));
+    ASSERT_EQ(COMPOSITE, trial_division(Bignum(997) * 1000033, 1000));
+}
+
+TEST(PrimalityTest, StrongPseudoprimesToBaseTwo) {
+    const int64_t pseudoprimes[] = { 2047, 3277, 4033, 4681, 8321, 3215031751LL };
+
+    for (unsigned int i = 0; i < sizeof(pseudoprimes) / sizeof(pseudoprimes[0]); ++i) {
+        ASSERT_TRUE(is_strong_probable_prime(Bignum(pseudoprimes[i]), Bignum(2)));
+        ASSERT_FALSE(is_strong_lucas_probable_prime(Bignum(pseudoprimes[i])));
+    }
+    ASSERT_FALSE(is_strong_probable_prime(Bignum(2047), Bignum(3)));
+}
+
+TEST(PrimalityTest, StrongLucasPseudoprimes) {
+    const int64_t pseudoprimes[] = { 5459, 5777, 10877, 16109, 18971, 22499 };
+
+    for (unsigned int i = 0; i < sizeof(pseudoprimes) / sizeof(pseudoprimes[0]); ++i) {
+        ASSERT_TRUE(is_strong_lucas_probable_prime(Bignum(pseudoprimes[i])));
+        ASSERT_FALSE(is_strong_probable_prime(Bignum(pseudoprimes[i]), Bignum(2)));
+    }
+    ASSERT_FALSE(is_strong_lucas_probable_prime(Bignum(5461)));
+    ASSERT_FALSE(is_strong_lucas_probable_prime(Bignum(10201)));
+}
+
+TEST(PrimalityTest, BailliePSWOnLargeValues) {
+    ASSERT_EQ(PROBABLE_PRIME, baillie_psw(mersenne(127)));
+    ASSERT_EQ(PROBABLE_PRIME, baillie_psw(mersenne(521)));
+    ASSERT_EQ(COMPOSITE, baillie_psw(mersenne(523)));
+    ASSERT_EQ(COMPOSITE, baillie_psw(mersenne(127) * mersenne(521)));
+    ASSERT_EQ(COMPOSITE, baillie_psw(mersenne(521) * mersenne(521)));
+    ASSERT_EQ(COMPOSITE, baillie_psw((Bignum(1) << 128) + 1));
+}
+
+TEST(PrimalityTest, ProthNumbers) {
+    ASSERT_TRUE(proth_test(3, 2));
+    ASSERT_TRUE(proth_test(3, 41));
+    ASSERT_FALSE(proth_test(3, 40));
+    ASSERT_TRUE(proth_test(3, 189));
+    ASSERT_FALSE(proth_test(3, 190));
+    ASSERT_FALSE(proth_test(3, 3));
+    ASSERT_THROW(proth_test(4, 10), std::invalid_argument);
+    ASSERT_THROW(proth_test(9, 3), std::invalid_argument);
+}
+
+TEST(PrimalityTest, FermatNumbers) {
+    for (unsigned int m = 0; m <= 4; ++m)
+        ASSERT_TRUE(pepin_test(m));
+    for (unsigned int m = 5; m <= 11; ++m)
+        ASSERT_FALSE(pepin_test(m));
+}
+
+TEST(PrimalityTest, RieselNumbers) {
+    ASSERT_TRUE(lucas_lehmer_riesel_test(3, 18));
+    ASSERT_TRUE(lucas_lehmer_riesel_test(3, 206));
+    ASSERT_FALSE(lucas_lehmer_riesel_test(3, 207));
+    ASSERT_TRUE(lucas_lehmer_riesel_test(1, 127));
+    ASSERT_FALSE(lucas_lehmer_riesel_test(1, 67));
+    ASSERT_TRUE(lucas_lehmer_riesel_test(1, 607));
+    ASSERT_FALSE(lucas_lehmer_riesel_test(1, 11));
+}
+
+TEST(PrimalityTest, SpecialFormTestsAgreeWithBailliePSW) {
+    for (uint64_t k = 1; k < 40; k += 2) {
+        for (uint64_t n = 6; n < 80; ++n) {
+            const Bignum power = (Bignum(0) + k) << (unsigned int) n;
+            ASSERT_EQ(baillie_psw(power + 1) != COMPOSITE, proth_test(k, n)) << k << " " << n;
+            ASSERT_EQ(baillie_psw(power - 1) != COMPOSITE, lucas_lehmer_riesel_test(k, n)) << k << " " << n;
+        }
+    }
+}
+
+TEST(PrimalityTest, ParallelScreening) {
+    std::vector<Bignum> candidates;
+    for (int i = 0; i < 200; ++i)
+        candidates.push_back((Bignum(1) << 89) + i);
+
+    std::vector<Primality> parallel = screen(candidates, 8);
+    std::vector<Primality> sequential = screen(candidates, 1);
+
+    ASSERT_EQ(candidates.size(), parallel.size());
+    for (std::vector<Bignum>::size_type i = 0; i < candidates.size(); ++i)
+        ASSERT_EQ(baillie_psw(candidates[i]), parallel[i]);
+    ASSERT_TRUE(parallel == sequential);
+}
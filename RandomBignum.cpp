@@ -0,0 +1,117 @@
+#include "RandomBignum.h"
+#include <deque>
+#include <stdexcept>
+
+uint64_t rotate_left(const uint64_t word, const int count) {
+    return (word << count) | (word >> (64 - count));
+}
+
+// splitmix64, which spreads a seed over the whole xoshiro state
+uint64_t split_mix(uint64_t& seed) {
+    uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+Bignum from_random_digits(std::deque<uint32_t>& digits) {
+    while (digits.size() > 1 && digits.back() == 0)
+        digits.pop_back();
+
+    return Bignum(digits, digits.back() == 0 ? 0 : 1);
+}
+
+RandomBignum::RandomBignum(uint64_t seed) {
+    for (int i = 0; i < 4; ++i)
+        state[i] = split_mix(seed);
+}
+
+uint64_t RandomBignum::next() {
+    const uint64_t result = rotate_left(state[1] * 5, 7) * 9;
+    const uint64_t t = state[1] << 17;
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotate_left(state[3], 45);
+
+    return result;
+}
+
+// Advances the generator by 2^128 outputs.
+void RandomBignum::jump() {
+    static const uint64_t JUMP[] = {
+        0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL
+    };
+
+    uint64_t jumped[4] = { 0, 0, 0, 0 };
+    for (int i = 0; i < 4; ++i) {
+        for (int b = 0; b < 64; ++b) {
+            if (JUMP[i] & (1ULL << b)) {
+                for (int j = 0; j < 4; ++j)
+                    jumped[j] ^= state[j];
+            }
+            next();
+        }
+    }
+
+    for (int j = 0; j < 4; ++j)
+        state[j] = jumped[j];
+}
+
+// uniform over [0, 2^bit_length)
+Bignum RandomBignum::bits(const uint64_t bit_length) {
+    const uint64_t num_digits = (bit_length + Bignum::BITS_IN_DIGIT - 1) / Bignum::BITS_IN_DIGIT;
+    if (num_digits == 0)
+        return Bignum(0);
+
+    std::deque<uint32_t> digits(num_digits, 0U);
+    std::deque<uint32_t>::iterator out = digits.begin();
+    for (uint64_t i = 0; i + 1 < num_digits; i += 2) {
+        const uint64_t word = next();
+        *out++ = (uint32_t) word;
+        *out++ = (uint32_t) (word >> Bignum::BITS_IN_DIGIT);
+    }
+    if (num_digits % 2 == 1)
+        *out = (uint32_t) (next() >> Bignum::BITS_IN_DIGIT);
+
+    const uint64_t top_bits = bit_length % Bignum::BITS_IN_DIGIT;
+    if (top_bits != 0)
+        digits.back() &= (1U << top_bits) - 1;
+
+    return from_random_digits(digits);
+}
+
+// uniform over [2^(bit_length - 1), 2^bit_length), so that the result's
+// bit_length() is exactly the one asked for
+Bignum RandomBignum::with_bit_length(const uint64_t bit_length) {
+    if (bit_length == 0)
+        return Bignum(0);
+
+    Bignum value = bits(bit_length - 1);
+    value.set_bit(bit_length - 1);
+    return value;
+}
+
+// uniform over [0, bound), by rejecting draws of bound's bit length that
+// land at or above it; fewer than two draws are needed on average
+Bignum RandomBignum::below(const Bignum& bound) {
+    if (bound.signum() <= 0)
+        throw std::invalid_argument("random bound must be positive");
+
+    const uint64_t bit_length = bound.bit_length();
+    Bignum value = bits(bit_length);
+    while (!value.less(bound))
+        value = bits(bit_length);
+    return value;
+}
+
+// uniform over [low, high]
+Bignum RandomBignum::between(const Bignum& low, const Bignum& high) {
+    if (high.less(low))
+        throw std::invalid_argument("random range is empty");
+
+    return low + below(high - low + 1);
+}
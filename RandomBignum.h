@@ -0,0 +1,27 @@
+#ifndef PHOLSER_RANDOM_BIGNUM_H
+#define PHOLSER_RANDOM_BIGNUM_H
+
+#include "Bignum.h"
+#include <tr1/cstdint>
+
+// Uniformly random Bignums from a xoshiro256** generator, reproducible
+// from a 64-bit seed.  Each 64-bit output fills two digits at once.
+// Instances are not shared between threads; give each thread its own
+// seed, or copies separated by jump().
+class RandomBignum {
+    public:
+        RandomBignum(uint64_t);
+
+        uint64_t next();
+        void jump();
+
+        Bignum bits(uint64_t);
+        Bignum with_bit_length(uint64_t);
+        Bignum below(const Bignum&);
+        Bignum between(const Bignum&, const Bignum&);
+
+    private:
+        uint64_t state[4];
+};
+
+#endif  // PHOLSER_RANDOM_BIGNUM_H
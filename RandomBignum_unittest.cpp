@@ -0,0 +1,94 @@
+#include "RandomBignum.h"
+#include "gtest/gtest.h"
+#include <stdexcept>
+#include <vector>
+
+TEST(RandomBignumTest, SameSeedSameValues) {
+    RandomBignum first(42);
+    RandomBignum second(42);
+    RandomBignum other(43);
+
+    for (int i = 0; i < 20; ++i) {
+        Bignum value = first.bits(1000);
+        ASSERT_EQ(value, second.bits(1000));
+        ASSERT_NE(value, other.bits(1000));
+    }
+}
+
+TEST(RandomBignumTest, JumpingStartsAnotherStream) {
+    RandomBignum generator(7);
+    RandomBignum jumped(7);
+    jumped.jump();
+
+    ASSERT_NE(generator.next(), jumped.next());
+}
+
+TEST(RandomBignumTest, ValuesFitTheirBitLengths) {
+    RandomBignum generator(1);
+    const uint64_t lengths[] = { 1, 2, 31, 32, 33, 63, 64, 65, 96, 1000 };
+
+    for (unsigned int i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i) {
+        for (int j = 0; j < 50; ++j) {
+            Bignum value = generator.bits(lengths[i]);
+            ASSERT_LE(value.bit_length(), lengths[i]);
+            ASSERT_GE(value.signum(), 0);
+            ASSERT_EQ(lengths[i], generator.with_bit_length(lengths[i]).bit_length());
+        }
+    }
+
+    ASSERT_EQ(Bignum(0), generator.bits(0));
+    ASSERT_EQ(Bignum(0), generator.with_bit_length(0));
+}
+
+TEST(RandomBignumTest, ZeroIsNormalized) {
+    RandomBignum generator(3);
+
+    for (int i = 0; i < 200; ++i) {
+        Bignum value = generator.bits(1);
+        if (value.signum() == 0) {
+            ASSERT_EQ(Bignum(0), value);
+            ASSERT_EQ(1U, value.digits().size());
+        }
+    }
+}
+
+TEST(RandomBignumTest, ValuesBelowABoundCoverTheRange) {
+    RandomBignum generator(5);
+    std::vector<int> seen(10, 0);
+
+    for (int i = 0; i < 1000; ++i) {
+        Bignum value = generator.below(Bignum(10));
+        ASSERT_GE(value, Bignum(0));
+        ASSERT_LT(value, Bignum(10));
+        ++seen[value.remainder(10)];
+    }
+    for (int i = 0; i < 10; ++i)
+        ASSERT_GT(seen[i], 50) << i;
+}
+
+TEST(RandomBignumTest, ValuesBetweenBoundsIncludeBoth) {
+    RandomBignum generator(11);
+    Bignum low = -(Bignum(1) << 100);
+    Bignum high = low + 2;
+    bool saw_low = false;
+    bool saw_high = false;
+
+    for (int i = 0; i < 100; ++i) {
+        Bignum value = generator.between(low, high);
+        ASSERT_GE(value, low);
+        ASSERT_LE(value, high);
+        saw_low = saw_low || value == low;
+        saw_high = saw_high || value == high;
+    }
+    ASSERT_TRUE(saw_low);
+    ASSERT_TRUE(saw_high);
+    ASSERT_EQ(Bignum(9), generator.between(Bignum(9), Bignum(9)));
+}
+
+TEST(RandomBignumTest, EmptyRangesAreRejected) {
+    RandomBignum generator(13);
+
+    ASSERT_THROW(generator.below(Bignum(0)), std::invalid_argument);
+    ASSERT_THROW(generator.below(Bignum(-5)), std::invalid_argument);
+    ASSERT_THROW(generator.between(Bignum(2), Bignum(1)), std::invalid_argument);
+}
@@ -0,0 +1,335 @@
+#include "ResidueNumber.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <stdexcept>
+
+const std::size_t ResidueSystem::PARALLEL_THRESHOLD = 1 << 14;
+
+unsigned int threads_for(const uint64_t work, const unsigned int threads) {
+    return work >= ResidueSystem::PARALLEL_THRESHOLD ? threads : 1;
+}
+
+// Deterministic Miller-Rabin: bases 2, 7 and 61 suffice below 4,759,123,141.
+bool is_word_prime(const uint32_t n) {
+    static const uint32_t bases[] = { 2, 7, 61 };
+
+    if (n < 2 || n % 2 == 0)
+        return n == 2;
+
+    uint32_t odd = n - 1;
+    unsigned int twos = 0;
+    for (; odd % 2 == 0; odd /= 2)
+        ++twos;
+
+    for (unsigned int i = 0; i < sizeof(bases) / sizeof(bases[0]); ++i) {
+        if (bases[i] % n == 0)
+            continue;
+
+        uint64_t x = word_power_mod(bases[i], odd, n);
+        if (x == 1 || x == n - 1)
+            continue;
+
+        unsigned int j = 1;
+        for (; j < twos; ++j) {
+            x = x * x % n;
+            if (x == n - 1)
+                break;
+        }
+        if (j == twos)
+            return false;
+    }
+
+    return true;
+}
+
+uint32_t word_inverse_mod(const uint32_t value, const uint32_t modulus) {
+    int64_t old_r = value % modulus;
+    int64_t r = modulus;
+    int64_t old_s = 1;
+    int64_t s = 0;
+
+    while (r != 0) {
+        int64_t quotient = old_r / r;
+        int64_t next_r = old_r - quotient * r;
+        old_r = r;
+        r = next_r;
+        int64_t next_s = old_s - quotient * s;
+        old_s = s;
+        s = next_s;
+    }
+
+    if (old_r != 1)
+        throw std::domain_error("value is not invertible");
+
+    return old_s < 0 ? old_s + modulus : old_s;
+}
+
+class CofactorInverseTask : public ParallelTask {
+    public:
+        CofactorInverseTask(const std::vector<uint32_t>& moduli, std::vector<uint32_t>& inverses)
+            : moduli(moduli), inverses(inverses) {
+        }
+
+        void run(std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                uint64_t cofactor = 1;
+                for (std::size_t j = 0; j < moduli.size(); ++j) {
+                    if (j != i)
+                        cofactor = cofactor * (moduli[j] % moduli[i]) % moduli[i];
+                }
+                inverses[i] = word_inverse_mod(cofactor, moduli[i]);
+            }
+        }
+
+    private:
+        const std::vector<uint32_t>& moduli;
+        std::vector<uint32_t>& inverses;
+};
+
+class SubproductTask : public ParallelTask {
+    public:
+        SubproductTask(const std::vector<Bignum>& below, std::vector<Bignum>& level)
+            : below(below), level(level) {
+        }
+
+        void run(std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i)
+                level[i] = 2 * i + 1 < below.size() ? below[2 * i] * below[2 * i + 1] : below[2 * i];
+        }
+
+    private:
+        const std::vector<Bignum>& below;
+        std::vector<Bignum>& level;
+};
+
+class ResidueTask : public ParallelTask {
+    public:
+        ResidueTask(const Bignum& value, const std::vector<uint32_t>& moduli, std::vector<uint32_t>& residues)
+            : value(value), moduli(moduli), residues(residues) {
+        }
+
+        void run(std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                uint32_t r = value.remainder(moduli[i]);
+                residues[i] = value.signum() < 0 && r != 0 ? moduli[i] - r : r;
+            }
+        }
+
+    private:
+        const Bignum& value;
+        const std::vector<uint32_t>& moduli;
+        std::vector<uint32_t>& residues;
+};
+
+// One level of the tree-shaped Chinese remainder combination: a parent
+// spanning moduli products A and B, with partial sums a and b below it,
+// gets a * B + b * A.
+class CombineTask : public ParallelTask {
+    public:
+        CombineTask(const std::vector<Bignum>& sums, const std::vector<Bignum>& products, std::vector<Bignum>& combined)
+            : sums(sums), products(products), combined(combined) {
+        }
+
+        void run(std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                if (2 * i + 1 < sums.size())
+                    combined[i] = sums[2 * i] * products[2 * i + 1] + sums[2 * i + 1] * products[2 * i];
+                else
+                    combined[i] = sums[2 * i];
+            }
+        }
+
+    private:
+        const std::vector<Bignum>& sums;
+        const std::vector<Bignum>& products;
+        std::vector<Bignum>& combined;
+};
+
+ResidueSystem::ResidueSystem(const uint64_t capacity_bits, const unsigned int threads)
+    : thread_count(std::max(threads, 1U)) {
+    // Every candidate exceeds 2^31, and one spare bit covers the sign.
+    for (uint32_t candidate = 0xFFFFFFFBU; moduli.size() * 31 < capacity_bits + 1; candidate -= 2) {
+        if (is_word_prime(candidate))
+            moduli.push_back(candidate);
+    }
+
+    cofactor_inverses.resize(moduli.size());
+    CofactorInverseTask inverses(moduli, cofactor_inverses);
+    parallel_for(inverses, moduli.size(), threads_for((uint64_t) moduli.size() * moduli.size(), thread_count));
+
+    subproducts.push_back(std::vector<Bignum>());
+    for (std::size_t i = 0; i < moduli.size(); ++i)
+        subproducts.back().push_back(Bignum((int64_t) moduli[i]));
+
+    while (subproducts.back().size() > 1) {
+        const std::vector<Bignum>& below = subproducts.back();
+        std::vector<Bignum> level((below.size() + 1) / 2, Bignum(0));
+        SubproductTask products(below, level);
+        parallel_for(products, level.size(), threads_for(below.size() * below.size(), thread_count));
+        subproducts.push_back(level);
+    }
+}
+
+std::size_t ResidueSystem::size() const {
+    return moduli.size();
+}
+
+uint32_t ResidueSystem::modulus(const std::size_t channel) const {
+    return moduli[channel];
+}
+
+const Bignum& ResidueSystem::product() const {
+    return subproducts.back()[0];
+}
+
+unsigned int ResidueSystem::threads() const {
+    return thread_count;
+}
+
+std::vector<uint32_t> ResidueSystem::residues_of(const Bignum& value) const {
+    std::vector<uint32_t> residues(moduli.size());
+    ResidueTask task(value, moduli, residues);
+    parallel_for(task, moduli.size(), threads_for(moduli.size() * value.digits().size(), thread_count));
+
+    return residues;
+}
+
+Bignum ResidueSystem::reconstruct(const std::vector<uint32_t>& residues) const {
+    std::vector<Bignum> sums;
+    for (std::size_t i = 0; i < moduli.size(); ++i)
+        sums.push_back(Bignum((int64_t) ((uint64_t) residues[i] * cofactor_inverses[i] % moduli[i])));
+
+    for (std::size_t level = 0; sums.size() > 1; ++level) {
+        std::vector<Bignum> combined((sums.size() + 1) / 2, Bignum(0));
+        CombineTask task(sums, subproducts[level], combined);
+        parallel_for(task, combined.size(), threads_for(sums.size() << level, thread_count));
+        sums.swap(combined);
+    }
+
+    Bignum result = sums[0] % product();
+    if ((result << 1) > product())
+        result -= product();
+
+    return result;
+}
+
+ChannelChain::~ChannelChain() {
+}
+
+uint32_t add_mod(const uint32_t left, const uint32_t right, const uint32_t modulus) {
+    return ((uint64_t) left + right) % modulus;
+}
+
+uint32_t subtract_mod(const uint32_t left, const uint32_t right, const uint32_t modulus) {
+    return ((uint64_t) left + modulus - right) % modulus;
+}
+
+uint32_t multiply_mod(const uint32_t left, const uint32_t right, const uint32_t modulus) {
+    return (uint64_t) left * right % modulus;
+}
+
+ResidueNumber::ResidueNumber(const ResidueSystem& system, const Bignum& value)
+    : system(&system), residues(system.residues_of(value)) {
+}
+
+ResidueNumber::ResidueNumber(const ResidueSystem& system, const std::vector<uint32_t>& residues)
+    : system(&system), residues(residues) {
+}
+
+class ChannelChainTask : public ParallelTask {
+    public:
+        ChannelChainTask(const ChannelChain& chain, const std::vector<ResidueNumber>& operands,
+            std::vector<uint32_t>& results)
+            : chain(chain), operands(operands), results(results) {
+        }
+
+        void run(std::size_t begin, std::size_t end) {
+            const ResidueSystem& system = *operands[0].system;
+            std::vector<uint32_t> channel(operands.size());
+
+            for (std::size_t i = begin; i < end; ++i) {
+                for (std::size_t j = 0; j < operands.size(); ++j)
+                    channel[j] = operands[j].residues[i];
+                results[i] = chain.evaluate(system.modulus(i), channel);
+            }
+        }
+
+    private:
+        const ChannelChain& chain;
+        const std::vector<ResidueNumber>& operands;
+        std::vector<uint32_t>& results;
+};
+
+// Evaluates the chain on every channel in a single parallel pass, with no
+// synchronization between channels until the pass ends.
+ResidueNumber ResidueNumber::apply_chain(const ChannelChain& chain, const std::vector<ResidueNumber>& operands) {
+    if (operands.empty())
+        throw std::invalid_argument("a chain needs at least one operand");
+    for (std::size_t j = 1; j < operands.size(); ++j) {
+        if (operands[j].system != operands[0].system)
+            throw std::invalid_argument("residue numbers belong to different systems");
+    }
+
+    const ResidueSystem& system = *operands[0].system;
+    std::vector<uint32_t> results(system.size());
+    ChannelChainTask task(chain, operands, results);
+    parallel_for(task, system.size(), threads_for((uint64_t) system.size() * operands.size(), system.threads()));
+
+    return ResidueNumber(system, results);
+}
+
+void ResidueNumber::apply(const Operation operation, const ResidueNumber& other) {
+    if (system != other.system)
+        throw std::invalid_argument("residue numbers belong to different systems");
+
+    for (std::size_t i = 0; i < residues.size(); ++i) {
+        const uint32_t modulus = system->modulus(i);
+
+        switch (operation) {
+            case ADD:
+                residues[i] = add_mod(residues[i], other.residues[i], modulus);
+                break;
+            case SUBTRACT:
+                residues[i] = subtract_mod(residues[i], other.residues[i], modulus);
+                break;
+            case MULTIPLY:
+                residues[i] = multiply_mod(residues[i], other.residues[i], modulus);
+                break;
+        }
+    }
+}
+
+const ResidueNumber& ResidueNumber::operator+=(const ResidueNumber& other) {
+    apply(ADD, other);
+    return *this;
+}
+
+const ResidueNumber& ResidueNumber::operator-=(const ResidueNumber& other) {
+    apply(SUBTRACT, other);
+    return *this;
+}
+
+const ResidueNumber& ResidueNumber::operator*=(const ResidueNumber& other) {
+    apply(MULTIPLY, other);
+    return *this;
+}
+
+uint32_t ResidueNumber::residue(const std::size_t channel) const {
+    return residues[channel];
+}
+
+Bignum ResidueNumber::to_bignum() const {
+    return system->reconstruct(residues);
+}
+
+ResidueNumber operator+(const ResidueNumber& left, const ResidueNumber& right) {
+    return ResidueNumber(left) += right;
+}
+
+ResidueNumber operator-(const ResidueNumber& left, const ResidueNumber& right) {
+    return ResidueNumber(left) -= right;
+}
+
+ResidueNumber operator*(const ResidueNumber& left, const ResidueNumber& right) {
+    return ResidueNumber(left) *= right;
+}
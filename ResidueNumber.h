@@ -0,0 +1,83 @@
+#ifndef PHOLSER_RESIDUE_NUMBER_H
+#define PHOLSER_RESIDUE_NUMBER_H
+
+#include "Bignum.h"
+#include <tr1/cstdint>
+#include <vector>
+
+// A set of word-sized primes whose product M bounds the values a residue
+// computation may pass through: every intermediate result must lie in
+// (-M/2, M/2).  Holds the subproduct tree used to reconstruct results.
+class ResidueSystem {
+    public:
+        static const std::size_t PARALLEL_THRESHOLD;
+
+        ResidueSystem(uint64_t, unsigned int);
+
+        std::size_t size() const;
+        uint32_t modulus(std::size_t) const;
+        const Bignum& product() const;
+        unsigned int threads() const;
+
+        std::vector<uint32_t> residues_of(const Bignum&) const;
+        Bignum reconstruct(const std::vector<uint32_t>&) const;
+
+    private:
+        std::vector<uint32_t> moduli;
+        std::vector<uint32_t> cofactor_inverses;
+        std::vector<std::vector<Bignum> > subproducts;
+        unsigned int thread_count;
+};
+
+// The arithmetic of one channel in a chain of operations: given that
+// channel's prime and its residues of each operand, returns the residue
+// of the chain's result.  Called concurrently for different channels.
+class ChannelChain {
+    public:
+        virtual ~ChannelChain();
+        virtual uint32_t evaluate(uint32_t, const std::vector<uint32_t>&) const = 0;
+};
+
+uint32_t add_mod(uint32_t, uint32_t, uint32_t);
+uint32_t subtract_mod(uint32_t, uint32_t, uint32_t);
+uint32_t multiply_mod(uint32_t, uint32_t, uint32_t);
+
+// A signed integer held as its residues modulo each prime of a
+// ResidueSystem.  Arithmetic runs on every channel independently, so long
+// chains of it never carry between channels; only to_bignum() combines
+// them again.  Single operations run on the calling thread, since one
+// word operation per channel costs less than handing channels to other
+// threads; apply_chain() runs a whole chain per channel in one parallel
+// pass.  The number keeps a pointer to its ResidueSystem, which must
+// outlive it and every number computed from it.
+class ResidueNumber {
+    public:
+        ResidueNumber(const ResidueSystem&, const Bignum&);
+
+        static ResidueNumber apply_chain(const ChannelChain&, const std::vector<ResidueNumber>&);
+
+        const ResidueNumber& operator+=(const ResidueNumber&);
+        const ResidueNumber& operator-=(const ResidueNumber&);
+        const ResidueNumber& operator*=(const ResidueNumber&);
+
+        uint32_t residue(std::size_t) const;
+        Bignum to_bignum() const;
+
+    private:
+        friend class ChannelChainTask;
+
+        enum Operation { ADD, SUBTRACT, MULTIPLY };
+
+        const ResidueSystem* system;
+        std::vector<uint32_t> residues;
+
+        ResidueNumber(const ResidueSystem&, const std::vector<uint32_t>&);
+
+        void apply(Operation, const ResidueNumber&);
+};
+
+ResidueNumber operator+(const ResidueNumber&, const ResidueNumber&);
+ResidueNumber operator-(const ResidueNumber&, const ResidueNumber&);
+ResidueNumber operator*(const ResidueNumber&, const ResidueNumber&);
+
+#endif  // PHOLSER_RESIDUE_NUMBER_H
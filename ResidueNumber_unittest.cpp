@@ -0,0 +1,98 @@
+#include "ResidueNumber.h"
+#include "gtest/gtest.h"
+#include <stdexcept>
+#include <vector>
+
+TEST(ResidueNumberTest, SystemCoversTheRequestedCapacity) {
+    ResidueSystem system(1000, 1);
+
+    ASSERT_LT(1001U, system.product().bit_length());
+    ASSERT_EQ(4294967291U, system.modulus(0));
+    ASSERT_EQ(4294967279U, system.modulus(1));
+}
+
+TEST(ResidueNumberTest, ResiduesOfAValue) {
+    ResidueSystem system(64, 1);
+    ResidueNumber n(system, Bignum(-5));
+
+    ASSERT_EQ(4294967286U, n.residue(0));
+    ASSERT_EQ(4294967274U, n.residue(1));
+}
+
+TEST(ResidueNumberTest, RoundTrip) {
+    ResidueSystem system(200, 1);
+    Bignum value = (Bignum(1) << 190) - Bignum(12345);
+
+    ASSERT_EQ(value, ResidueNumber(system, value).to_bignum());
+    ASSERT_EQ(-value, ResidueNumber(system, -value).to_bignum());
+    ASSERT_EQ(Bignum(0), ResidueNumber(system, Bignum(0)).to_bignum());
+}
+
+TEST(ResidueNumberTest, ChainOfArithmetic) {
+    ResidueSystem system(600, 2);
+    ResidueNumber product(system, Bignum(1));
+    Bignum expected(1);
+
+    for (int i = 1; i <= 100; ++i) {
+        product *= ResidueNumber(system, Bignum(i));
+        expected *= Bignum(i);
+    }
+    product = product - ResidueNumber(system, expected) * ResidueNumber(system, Bignum(2))
+        + ResidueNumber(system, Bignum(7));
+
+    ASSERT_EQ(-expected + Bignum(7), product.to_bignum());
+}
+
+// The product of all operands but the last, minus the last.
+class ProductMinusLast : public ChannelChain {
+    public:
+        uint32_t evaluate(uint32_t modulus, const std::vector<uint32_t>& operands) const {
+            uint32_t product = 1;
+            for (std::size_t i = 0; i + 1 < operands.size(); ++i)
+                product = multiply_mod(product, operands[i], modulus);
+
+            return subtract_mod(product, operands.back(), modulus);
+        }
+};
+
+TEST(ResidueNumberTest, ChainsRunPerChannelInOnePass) {
+    ResidueSystem system(20000, 4);
+    std::vector<ResidueNumber> operands;
+    Bignum expected(1);
+    for (int i = 1; i <= 1000; ++i) {
+        operands.push_back(ResidueNumber(system, Bignum(i)));
+        expected *= Bignum(i);
+    }
+    Bignum last = (Bignum(1) << 9000) + 5;
+    operands.push_back(ResidueNumber(system, last));
+
+    ASSERT_EQ(expected - last, ResidueNumber::apply_chain(ProductMinusLast(), operands).to_bignum());
+}
+
+TEST(ResidueNumberTest, ChainsNeedOperandsFromOneSystem) {
+    ResidueSystem first(64, 1);
+    ResidueSystem second(64, 1);
+    std::vector<ResidueNumber> operands;
+
+    ASSERT_THROW(ResidueNumber::apply_chain(ProductMinusLast(), operands), std::invalid_argument);
+    operands.push_back(ResidueNumber(first, Bignum(1)));
+    operands.push_back(ResidueNumber(second, Bignum(1)));
+    ASSERT_THROW(ResidueNumber::apply_chain(ProductMinusLast(), operands), std::invalid_argument);
+}
+
+TEST(ResidueNumberTest, ManyChannelsAcrossThreads) {
+    ResidueSystem system(80000, 4);
+    Bignum value = (Bignum(3) << 39000) + Bignum(1);
+    ResidueNumber n(system, value);
+    n *= n;
+
+    ASSERT_EQ(value * value, n.to_bignum());
+}
+
+TEST(ResidueNumberTest, NumbersFromDifferentSystemsDoNotMix) {
+    ResidueSystem first(64, 1);
+    ResidueSystem second(64, 1);
+    ResidueNumber n(first, Bignum(1));
+
+    ASSERT_THROW(n += ResidueNumber(second, Bignum(1)), std::invalid_argument);
+}
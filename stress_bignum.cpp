@@ -0,0 +1,211 @@
+#include "Bignum.h"
+#include "Parallel.h"
+#include "RandomBignum.h"
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <tr1/cstdint>
+#include <vector>
+#include <sys/time.h>
+
+// Checks algebraic identities of Bignum over random signed operands, on
+// every hardware thread, and times each phase:
+//
+//     stress_bignum [operands [max_bits [threads [seed]]]]
+//
+// Operands are drawn in batches, each from its own generator seeded from
+// the run's seed and the batch number, so any run can be replayed from
+// the seed it prints whatever the thread count.
+
+const uint64_t OPERANDS_PER_BATCH = 4096;
+
+double elapsed_seconds() {
+    timeval time;
+    gettimeofday(&time, 0);
+    return time.tv_sec + time.tv_usec / 1e6;
+}
+
+// A value of random sign whose bit length is uniform over [0, max_bits].
+Bignum random_operand(RandomBignum& generator, const uint64_t max_bits) {
+    Bignum value = generator.bits(generator.next() % (max_bits + 1));
+    return (generator.next() & 1) ? -value : value;
+}
+
+class StressPhase : public ParallelTask {
+    public:
+        StressPhase(uint64_t seed, uint64_t operands, uint64_t max_bits)
+            : seed(seed), operands(operands), failures(batches(), 0), first_failures(batches()),
+              max_bits(max_bits) {
+        }
+
+        std::size_t batches() const {
+            return (operands + OPERANDS_PER_BATCH - 1) / OPERANDS_PER_BATCH;
+        }
+
+        void run(std::size_t begin, std::size_t end) {
+            for (std::size_t batch = begin; batch < end; ++batch) {
+                RandomBignum generator(seed + batch);
+                const uint64_t first = batch * OPERANDS_PER_BATCH;
+                const uint64_t last = std::min(operands, first + OPERANDS_PER_BATCH);
+
+                std::ostringstream failure;
+                for (uint64_t i = first; i < last; ++i) {
+                    if (!check(generator, failure)) {
+                        if (failures[batch]++ == 0)
+                            first_failures[batch] = failure.str();
+                        failure.str("");
+                    }
+                }
+            }
+        }
+
+        // The number of failures, after writing the first one to out.
+        uint64_t report(std::ostream& out) const {
+            uint64_t total = 0;
+            for (std::size_t batch = 0; batch < failures.size(); ++batch) {
+                if (failures[batch] > 0 && total == 0)
+                    out << "  first failure in batch " << batch << ": " << first_failures[batch] << '\n';
+                total += failures[batch];
+            }
+            return total;
+        }
+
+    private:
+        const uint64_t seed;
+        const uint64_t operands;
+        std::vector<uint64_t> failures;
+        std::vector<std::string> first_failures;
+
+    protected:
+        const uint64_t max_bits;
+
+        virtual bool check(RandomBignum&, std::ostream&) = 0;
+};
+
+// (a + b) - b == a and (a - b) + b == a
+class AdditionPhase : public StressPhase {
+    public:
+        AdditionPhase(uint64_t seed, uint64_t operands, uint64_t max_bits)
+            : StressPhase(seed, operands, max_bits) {
+        }
+
+    protected:
+        bool check(RandomBignum& generator, std::ostream& failure) {
+            Bignum a = random_operand(generator, max_bits);
+            Bignum b = random_operand(generator, max_bits);
+
+            if ((a + b) - b == a && (a - b) + b == a)
+                return true;
+
+            failure << "a = " << a << ", b = " << b;
+            return false;
+        }
+};
+
+// (a << k) >> k == a
+class ShiftPhase : public StressPhase {
+    public:
+        ShiftPhase(uint64_t seed, uint64_t operands, uint64_t max_bits)
+            : StressPhase(seed, operands, max_bits) {
+        }
+
+    protected:
+        bool check(RandomBignum& generator, std::ostream& failure) {
+            Bignum a = random_operand(generator, max_bits);
+            unsigned int k = (unsigned int) (generator.next() % (max_bits + 1));
+
+            if (((a << k) >> k) == a)
+                return true;
+
+            failure << "a = " << a << ", k = " << k;
+            return false;
+        }
+};
+
+// less() is a strict total order that agrees with compare(), equal() and
+// the sign of the difference.  Nearby and equal operands are drawn often
+// enough to exercise comparisons that reach the low digits.
+class OrderingPhase : public StressPhase {
+    public:
+        OrderingPhase(uint64_t seed, uint64_t operands, uint64_t max_bits)
+            : StressPhase(seed, operands, max_bits) {
+        }
+
+    protected:
+        Bignum near(RandomBignum& generator, const Bignum& a) {
+            switch (generator.next() % 4) {
+                case 0:
+                    return a;
+                case 1:
+                    return a + random_operand(generator, 32);
+                default:
+                    return random_operand(generator, max_bits);
+            }
+        }
+
+        bool consistent(const Bignum& a, const Bignum& b) {
+            const bool before = a.less(b);
+            const bool after = b.less(a);
+            const bool same = a.equal(b);
+            const int difference = (a - b).signum();
+
+            return before + after + same == 1
+                && before == (a.compare(b) < 0)
+                && same == (a.compare(b) == 0)
+                && before == (difference < 0)
+                && same == (difference == 0);
+        }
+
+        bool check(RandomBignum& generator, std::ostream& failure) {
+            Bignum a = random_operand(generator, max_bits);
+            Bignum b = near(generator, a);
+            Bignum c = near(generator, b);
+
+            bool transitive = !(a.less(b) && b.less(c)) || a.less(c);
+            transitive = transitive && (!(c.less(b) && b.less(a)) || c.less(a));
+            if (consistent(a, b) && consistent(b, c) && consistent(a, c) && transitive)
+                return true;
+
+            failure << "a = " << a << ", b = " << b << ", c = " << c;
+            return false;
+        }
+};
+
+uint64_t run_phase(const char* name, StressPhase& phase, uint64_t operands, unsigned int threads) {
+    double start = elapsed_seconds();
+    parallel_for(phase, phase.batches(), threads);
+    double seconds = elapsed_seconds() - start;
+
+    std::cout << name << ": " << operands << " operands in " << seconds << " s ("
+        << (seconds > 0 ? operands / seconds : 0) << " per second)\n";
+    uint64_t failures = phase.report(std::cout);
+    if (failures > 0)
+        std::cout << "  " << failures << " failures\n";
+    return failures;
+}
+
+uint64_t argument(int argc, char** argv, int index, uint64_t fallback) {
+    return argc > index ? std::strtoull(argv[index], 0, 10) : fallback;
+}
+
+int main(int argc, char** argv) {
+    const uint64_t operands = argument(argc, argv, 1, 1000000);
+    const uint64_t max_bits = argument(argc, argv, 2, 2048);
+    const unsigned int threads = (unsigned int) argument(argc, argv, 3, hardware_threads());
+    const uint64_t seed = argument(argc, argv, 4, (uint64_t) std::time(0));
+
+    std::cout << "stress_bignum " << operands << ' ' << max_bits << ' ' << threads << ' ' << seed << '\n';
+
+    AdditionPhase addition(seed, operands, max_bits);
+    ShiftPhase shift(seed ^ 0x5555555555555555ULL, operands, max_bits);
+    OrderingPhase ordering(seed ^ 0xAAAAAAAAAAAAAAAAULL, operands, max_bits);
+
+    uint64_t failures = run_phase("(a + b) - b == a", addition, operands, threads);
+    failures += run_phase("(a << k) >> k == a", shift, operands, threads);
+    failures += run_phase("less() ordering", ordering, operands, threads);
+
+    return failures == 0 ? 0 : 1;
+}
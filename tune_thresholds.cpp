@@ -0,0 +1,196 @@
+#include "Bignum.h"
+#include "RandomBignum.h"
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <tr1/cstdint>
+#include <sys/time.h>
+
+// Times each tier of Bignum's algorithms across operand sizes on this
+// machine and writes the crossover points where Bignum looks for them:
+//
+//     tune_thresholds [file]
+//
+// The file defaults to bignum_thresholds.conf; point $BIGNUM_THRESHOLDS
+// at it to use it from another directory.
+
+const double MINIMUM_TIMING_SECONDS = 0.02;
+const std::size_t NEVER = 1000000000;
+
+class TimedOperation {
+    public:
+        virtual ~TimedOperation() {
+        }
+
+        virtual void run() = 0;
+};
+
+class Addition : public TimedOperation {
+    public:
+        Addition(const Bignum& first, const Bignum& second) : first(first), second(second) {
+        }
+
+        void run() {
+            Bignum sum = first + second;
+            Bignum difference = sum - second;
+        }
+
+    private:
+        Bignum first;
+        Bignum second;
+};
+
+class LeftShift : public TimedOperation {
+    public:
+        LeftShift(const Bignum& value, unsigned int shift) : value(value), shift(shift) {
+        }
+
+        void run() {
+            Bignum shifted = value << shift;
+        }
+
+    private:
+        Bignum value;
+        unsigned int shift;
+};
+
+class Multiplication : public TimedOperation {
+    public:
+        Multiplication(const Bignum& first, const Bignum& second) : first(first), second(second) {
+        }
+
+        void run() {
+            Bignum product = first * second;
+        }
+
+    private:
+        Bignum first;
+        Bignum second;
+};
+
+double now() {
+    timeval time;
+    gettimeofday(&time, 0);
+    return time.tv_sec + time.tv_usec / 1e6;
+}
+
+double seconds_per_run(TimedOperation& operation, const BignumThresholds& thresholds) {
+    set_bignum_thresholds(thresholds);
+
+    operation.run();
+    uint64_t runs = 0;
+    double start = now();
+    double elapsed;
+    do {
+        operation.run();
+        ++runs;
+        elapsed = now() - start;
+    } while (elapsed < MINIMUM_TIMING_SECONDS);
+
+    return elapsed / runs;
+}
+
+Bignum random_value(RandomBignum& random, const std::size_t num_digits) {
+    return random.with_bit_length(num_digits * Bignum::BITS_IN_DIGIT);
+}
+
+// The smallest size from which the faster tier keeps winning, or NEVER.
+std::size_t crossover(const std::deque<std::size_t>& sizes, const std::deque<bool>& faster_wins) {
+    std::size_t threshold = NEVER;
+    for (std::size_t i = sizes.size(); i > 0 && faster_wins[i - 1]; --i)
+        threshold = sizes[i - 1];
+    return threshold;
+}
+
+void report(const char* tier, std::size_t size, double slower, double faster) {
+    std::cout << tier << '\t' << size << '\t' << slower * 1e9 << " ns\t" << faster * 1e9 << " ns\n";
+}
+
+std::size_t tune_block_add(RandomBignum& random) {
+    std::deque<std::size_t> sizes;
+    std::deque<bool> faster_wins;
+    for (std::size_t size = 1; size <= 256; size *= 2) {
+        Addition addition(random_value(random, size), random_value(random, size));
+
+        BignumThresholds digitwise;
+        digitwise.block_add_digits = NEVER;
+        BignumThresholds block;
+        block.block_add_digits = 0;
+
+        double slower = seconds_per_run(addition, digitwise);
+        double faster = seconds_per_run(addition, block);
+        report("block_add_digits", size, slower, faster);
+        sizes.push_back(size);
+        faster_wins.push_back(faster < slower);
+    }
+    return crossover(sizes, faster_wins);
+}
+
+std::size_t tune_bulk_shift(RandomBignum& random) {
+    std::deque<std::size_t> sizes;
+    std::deque<bool> faster_wins;
+    for (std::size_t size = 1; size <= 256; size *= 2) {
+        LeftShift shift(random_value(random, 64), (unsigned int) (size * Bignum::BITS_IN_DIGIT));
+
+        BignumThresholds incremental;
+        incremental.bulk_shift_digits = NEVER;
+        BignumThresholds bulk;
+        bulk.bulk_shift_digits = 0;
+
+        double slower = seconds_per_run(shift, incremental);
+        double faster = seconds_per_run(shift, bulk);
+        report("bulk_shift_digits", size, slower, faster);
+        sizes.push_back(size);
+        faster_wins.push_back(faster < slower);
+    }
+    return crossover(sizes, faster_wins);
+}
+
+// Compares schoolbook multiplication against one level of Karatsuba over
+// schoolbook halves, which is the decision the threshold makes.
+std::size_t tune_karatsuba(RandomBignum& random) {
+    std::deque<std::size_t> sizes;
+    std::deque<bool> faster_wins;
+    for (std::size_t size = 8; size <= 512; size += size / 2) {
+        Multiplication multiplication(random_value(random, size), random_value(random, size));
+
+        BignumThresholds schoolbook;
+        schoolbook.karatsuba_digits = NEVER;
+        BignumThresholds one_level;
+        one_level.karatsuba_digits = size;
+
+        double slower = seconds_per_run(multiplication, schoolbook);
+        double faster = seconds_per_run(multiplication, one_level);
+        report("karatsuba_digits", size, slower, faster);
+        sizes.push_back(size);
+        faster_wins.push_back(faster < slower);
+    }
+    return crossover(sizes, faster_wins);
+}
+
+int main(int argc, char** argv) {
+    if (argc > 2 || (argc == 2 && argv[1][0] == '-')) {
+        std::cerr << "usage: tune_thresholds [output-file]\n"
+            << "Times Bignum's algorithm tiers and writes the crossovers, by default to bignum_thresholds.conf.\n";
+        return 1;
+    }
+
+    const char* path = argc > 1 ? argv[1] : "bignum_thresholds.conf";
+    RandomBignum random(20111118);
+
+    BignumThresholds tuned;
+    tuned.block_add_digits = tune_block_add(random);
+    tuned.bulk_shift_digits = tune_bulk_shift(random);
+    tuned.karatsuba_digits = tune_karatsuba(random);
+
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "tune_thresholds: cannot write " << path << '\n';
+        return 1;
+    }
+    out << "# Written by tune_thresholds; sizes are in 32-bit digits.\n";
+    write_bignum_thresholds(out, tuned);
+
+    write_bignum_thresholds(std::cout, tuned);
+    return 0;
+}